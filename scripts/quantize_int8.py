@@ -0,0 +1,305 @@
+#!/usr/bin/env python3
+"""Build a QDQ INT8 model from tensors recorded by ofxDVS and report its accuracy.
+
+Record calibration data first: enable "RECORD CALIBRATION" in the NN panel and
+replay one or more AEDAT recordings.  The addon writes the exact model inputs
+(VTEI for YOLO, binned event tensors for TSDT / TPDVSGesture) to
+
+    bin/data/calib/<tag>/NNNNNN.bin   raw float32
+    bin/data/calib/<tag>/shape.txt    tensor shape, e.g. "1 5 288 352"
+    bin/data/calib/<tag>/resets.txt   stateful models: indices where the
+                                      live SNN state was reset
+
+Then, for each model:
+
+    python3 scripts/quantize_int8.py --model bin/data/ReYOLOv8m_PEDRO_352x288.onnx \\
+                                     --calib bin/data/calib/yolo --task yolo
+    python3 scripts/quantize_int8.py --model bin/data/tp_gesture_paper_32x32.onnx \\
+                                     --calib bin/data/calib/tpdvs --task cls
+
+The result is written next to the model as <stem>.int8.onnx, which OnnxRunner
+loads instead of the float model when present (Config::prefer_int8).  The model
+is tagged with the "dvs.quantization" metadata key.
+
+Stateful SNN models (inputs "state_in", outputs "state_out") are calibrated and
+evaluated as sequences.  The addon records every tensor of such models (no
+stride), starting from a zeroed state, so carrying the membrane state from one
+recorded tensor to the next and zeroing it at the indices in resets.txt
+reproduces the live state.  The held-out tail is evaluated after running the
+whole sequence, each model carrying its own state.
+
+The tail of the recording (--eval-frac) is held out from calibration and used
+to compare float and INT8 outputs: output error, top-1 agreement (--task cls)
+or detection agreement (--task yolo), and CPU latency.  The report is printed
+and saved as <stem>.int8.report.txt.
+
+Requires: numpy, onnx, onnxruntime (>= 1.16).
+"""
+
+import argparse
+import glob
+import os
+import sys
+import time
+
+import numpy as np
+import onnx
+import onnxruntime as ort
+from onnxruntime.quantization import (CalibrationDataReader, CalibrationMethod,
+                                      QuantFormat, QuantType, quantize_static)
+
+QUANT_TAG_KEY = "dvs.quantization"
+QUANT_TAG = "int8-qdq"
+
+
+# ---- recorded tensors ----
+
+def load_tensors(calib_dir):
+    with open(os.path.join(calib_dir, "shape.txt")) as f:
+        shape = [int(v) for v in f.read().split()]
+    files = sorted(glob.glob(os.path.join(calib_dir, "*.bin")))
+    if not files:
+        sys.exit("no .bin tensors in " + calib_dir)
+    n = int(np.prod(shape))
+    out = []
+    for p in files:
+        a = np.fromfile(p, dtype=np.float32)
+        if a.size != n:
+            print("skip %s: %d values, expected %d" % (p, a.size, n))
+            continue
+        out.append(a.reshape(shape))
+    return out
+
+
+def load_resets(calib_dir):
+    """Indices at which the live SNN state was zeroed (empty if not recorded)."""
+    p = os.path.join(calib_dir, "resets.txt")
+    if not os.path.exists(p):
+        return set()
+    with open(p) as f:
+        return {int(v) for v in f.read().split()}
+
+
+def io_names(sess):
+    ins = [i.name for i in sess.get_inputs()]
+    outs = [o.name for o in sess.get_outputs()]
+    return ins, outs
+
+
+def is_stateful(sess):
+    ins, outs = io_names(sess)
+    return "state_in" in ins and "state_out" in outs
+
+
+def state_shape(sess):
+    for i in sess.get_inputs():
+        if i.name == "state_in":
+            return [d if isinstance(d, int) and d > 0 else 1 for d in i.shape]
+    return None
+
+
+def input_dtype(sess, name):
+    for i in sess.get_inputs():
+        if i.name == name:
+            return np.float16 if i.type == "tensor(float16)" else np.float32
+    return np.float32
+
+
+def feeds_for(sess, tensors, resets=()):
+    """Yield one feed dict per tensor; chains SNN state for stateful models,
+    zeroing it before the tensors whose index is in `resets`."""
+    ins, _ = io_names(sess)
+    x_name = [n for n in ins if n != "state_in"][0]
+    x_type = input_dtype(sess, x_name)
+    if not is_stateful(sess):
+        for t in tensors:
+            yield {x_name: t.astype(x_type)}
+        return
+    s_type = input_dtype(sess, "state_in")
+    zero = np.zeros(state_shape(sess), dtype=s_type)
+    state = zero
+    for k, t in enumerate(tensors):
+        if k in resets:
+            state = zero
+        feed = {x_name: t.astype(x_type), "state_in": state}
+        yield feed
+        state = sess.run(["state_out"], feed)[0].astype(s_type)
+
+
+class RecordedReader(CalibrationDataReader):
+    def __init__(self, model_path, tensors, resets=()):
+        sess = ort.InferenceSession(model_path, providers=["CPUExecutionProvider"])
+        # Materialise feeds up front: the calibrator owns its own session
+        self.feeds = iter(list(feeds_for(sess, tensors, resets)))
+
+    def get_next(self):
+        return next(self.feeds, None)
+
+
+# ---- accuracy ----
+
+def run_all(sess, tensors, resets=(), skip=0):
+    """Run the sequence; outputs and median latency of tensors[skip:]."""
+    outs, ms = [], []
+    _, out_names = io_names(sess)
+    for k, feed in enumerate(feeds_for(sess, tensors, resets)):
+        if k < skip:
+            sess.run(out_names, feed)
+            continue
+        t0 = time.perf_counter()
+        r = sess.run(out_names, feed)
+        ms.append((time.perf_counter() - t0) * 1e3)
+        outs.append(dict(zip(out_names, [np.asarray(v, dtype=np.float32) for v in r])))
+    return outs, float(np.median(ms)) if ms else 0.0
+
+
+def sigmoid(x):
+    return 1.0 / (1.0 + np.exp(-x))
+
+
+def yolo_dets(out, conf, iou):
+    """Decode [1, 4+nc, N] like YoloPipeline::infer (sigmoid scores + NMS)."""
+    v = out.reshape(out.shape[-2], out.shape[-1])
+    boxes = v[:4].T
+    scores = sigmoid(v[4:])
+    cls = scores.argmax(0)
+    best = scores.max(0)
+    keep = (best >= conf) & (boxes[:, 2] > 1) & (boxes[:, 3] > 1)
+    b, s, c = boxes[keep], best[keep], cls[keep]
+    xyxy = np.stack([b[:, 0] - b[:, 2] / 2, b[:, 1] - b[:, 3] / 2,
+                     b[:, 0] + b[:, 2] / 2, b[:, 1] + b[:, 3] / 2], 1)
+    order = np.argsort(-s)
+    kept = []
+    while order.size:
+        i = order[0]
+        kept.append(i)
+        order = order[1:]
+        if order.size:
+            ious = box_iou(xyxy[i:i + 1], xyxy[order])[0]
+            order = order[(ious < iou) | (c[order] != c[i])]
+    return xyxy[kept], c[kept]
+
+
+def box_iou(a, b):
+    x1 = np.maximum(a[:, None, 0], b[None, :, 0])
+    y1 = np.maximum(a[:, None, 1], b[None, :, 1])
+    x2 = np.minimum(a[:, None, 2], b[None, :, 2])
+    y2 = np.minimum(a[:, None, 3], b[None, :, 3])
+    inter = np.clip(x2 - x1, 0, None) * np.clip(y2 - y1, 0, None)
+    area = lambda r: (r[:, 2] - r[:, 0]) * (r[:, 3] - r[:, 1])
+    return inter / np.maximum(area(a)[:, None] + area(b)[None, :] - inter, 1e-9)
+
+
+def compare(ref, q, task, args):
+    lines = []
+    for name in ref[0]:
+        r = np.stack([o[name].ravel() for o in ref])
+        d = np.stack([o[name].ravel() for o in q])
+        err = np.abs(r - d)
+        cos = np.sum(r * d, 1) / np.maximum(np.linalg.norm(r, axis=1) * np.linalg.norm(d, axis=1), 1e-12)
+        lines.append("output %-12s max|d| %.4g  mean|d| %.4g  cosine %.5f"
+                     % (name, err.max(), err.mean(), cos.mean()))
+
+    if task == "cls":
+        name = "logits" if "logits" in ref[0] else list(ref[0])[0]
+        top_r = np.array([o[name].argmax() for o in ref])
+        top_q = np.array([o[name].argmax() for o in q])
+        lines.append("top-1 agreement %.1f%% (%d/%d)"
+                     % (100.0 * np.mean(top_r == top_q), np.sum(top_r == top_q), len(top_r)))
+    elif task == "yolo":
+        name = "output0" if "output0" in ref[0] else list(ref[0])[0]
+        n_ref = n_q = matched = 0
+        ious = []
+        for o_r, o_q in zip(ref, q):
+            br, cr = yolo_dets(o_r[name], args.conf, args.iou)
+            bq, cq = yolo_dets(o_q[name], args.conf, args.iou)
+            n_ref += len(br)
+            n_q += len(bq)
+            if len(br) and len(bq):
+                m = box_iou(br, bq) * (cr[:, None] == cq[None, :])
+                best = m.max(1)
+                matched += int(np.sum(best >= 0.5))
+                ious.extend(best[best >= 0.5].tolist())
+        lines.append("detections float %d, int8 %d, matched (IoU>=0.5, same class) %d" % (n_ref, n_q, matched))
+        if n_ref:
+            lines.append("recall vs float %.1f%%, precision vs float %.1f%%, mean IoU %.3f"
+                         % (100.0 * matched / n_ref, 100.0 * matched / max(n_q, 1),
+                            np.mean(ious) if ious else 0.0))
+    return lines
+
+
+# ---- main ----
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("--model", required=True, help="float32/float16 .onnx model")
+    ap.add_argument("--calib", required=True, help="directory with recorded .bin tensors")
+    ap.add_argument("--out", help="output path (default <stem>.int8.onnx)")
+    ap.add_argument("--task", choices=["yolo", "cls", "none"], default="none",
+                    help="task-level accuracy metric for the report")
+    ap.add_argument("--eval-frac", type=float, default=0.2, help="held-out tail of the recording")
+    ap.add_argument("--max-calib", type=int, default=300, help="tensors used for calibration")
+    ap.add_argument("--method", choices=["minmax", "entropy", "percentile"], default="minmax")
+    ap.add_argument("--per-channel", action="store_true", help="per-channel weight scales")
+    ap.add_argument("--conf", type=float, default=0.5, help="YOLO score threshold for --task yolo")
+    ap.add_argument("--iou", type=float, default=0.45, help="YOLO NMS IoU for --task yolo")
+    args = ap.parse_args()
+
+    probe = ort.InferenceSession(args.model, providers=["CPUExecutionProvider"])
+    if any(i.type == "tensor(float16)" for i in probe.get_inputs()):
+        sys.exit("quantize the float32 export; float16 models cannot be calibrated")
+    del probe
+
+    out_path = args.out or (args.model[:-5] if args.model.endswith(".onnx") else args.model) + ".int8.onnx"
+    tensors = load_tensors(args.calib)
+    resets = load_resets(args.calib)
+    n_eval = max(1, int(len(tensors) * args.eval_frac))
+    if len(tensors) <= n_eval:
+        sys.exit("need more than %d tensors (have %d)" % (n_eval, len(tensors)))
+    calib, held = tensors[:-n_eval], tensors[-n_eval:]
+    calib = calib[:args.max_calib]
+    print("calibrating on %d tensors, evaluating on %d" % (len(calib), len(held)))
+
+    method = {"minmax": CalibrationMethod.MinMax,
+              "entropy": CalibrationMethod.Entropy,
+              "percentile": CalibrationMethod.Percentile}[args.method]
+    quantize_static(args.model, out_path, RecordedReader(args.model, calib, resets),
+                    quant_format=QuantFormat.QDQ,
+                    activation_type=QuantType.QInt8,
+                    weight_type=QuantType.QInt8,
+                    per_channel=args.per_channel,
+                    calibrate_method=method)
+
+    m = onnx.load(out_path)
+    tag = next((p for p in m.metadata_props if p.key == QUANT_TAG_KEY), None) or m.metadata_props.add()
+    tag.key, tag.value = QUANT_TAG_KEY, QUANT_TAG
+    onnx.save(m, out_path)
+    print("wrote", out_path)
+
+    so = ort.SessionOptions()
+    so.intra_op_num_threads = max(1, (os.cpu_count() or 2) // 2)
+    s_ref = ort.InferenceSession(args.model, so, providers=["CPUExecutionProvider"])
+    s_q = ort.InferenceSession(out_path, so, providers=["CPUExecutionProvider"])
+    if is_stateful(s_ref):
+        # The tail starts mid-sequence: run everything before it for the state
+        skip = len(tensors) - n_eval
+        ref, ms_ref = run_all(s_ref, tensors, resets, skip)
+        q, ms_q = run_all(s_q, tensors, resets, skip)
+    else:
+        ref, ms_ref = run_all(s_ref, held)
+        q, ms_q = run_all(s_q, held)
+
+    report = ["model  %s" % args.model,
+              "int8   %s (%s, %s calibration, %d tensors%s)"
+              % (out_path, QUANT_TAG, args.method, len(calib), ", per-channel" if args.per_channel else ""),
+              "eval   %d held-out tensors from %s" % (len(held), args.calib),
+              "latency median float %.2f ms, int8 %.2f ms (x%.2f)" % (ms_ref, ms_q, ms_ref / max(ms_q, 1e-9))]
+    report += compare(ref, q, args.task, args)
+    text = "\n".join(report)
+    print(text)
+    with open(out_path[:-5] + ".report.txt", "w") as f:
+        f.write(text + "\n")
+
+
+if __name__ == "__main__":
+    main()
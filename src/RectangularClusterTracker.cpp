@@ -973,6 +973,19 @@ void RectangularClusterTracker::updateClusterList(int64_t t) {
     }
 }
 // ---------------------------------------------------------------------------
+std::vector<ofRectangle> RectangularClusterTracker::getVisibleClusterBounds() const {
+    std::vector<ofRectangle> out;
+    out.reserve(visibleClusters.size());
+    const ofRectangle chip(0, 0, chipSizeX, chipSizeY);
+    for (const ClusterPtr& c : visibleClusters) {
+        const Point2D<float>& loc = c->getLocation();
+        const float rx = c->getRadiusX(), ry = c->getRadiusY();
+        ofRectangle b = ofRectangle(loc.x - rx, loc.y - ry, 2.f * rx, 2.f * ry).getIntersection(chip);
+        if (b.getWidth() > 0 && b.getHeight() > 0) out.push_back(b);
+    }
+    return out;
+}
+// ---------------------------------------------------------------------------
 void RectangularClusterTracker::draw(const ofRectangle& stage) {
     ofPushMatrix();
     ofTranslate(stage.getTopLeft());
@@ -7,6 +7,7 @@
 #include "ofxDvsPolarity.hpp"
 
 #include <limits>
+#include <vector>
 #include <deque>
 #include <list>
 #include <map>
@@ -376,6 +377,9 @@ public:
     void resetVanishingPoint() { vanishingPoint.reset(); }
     void draw(const ofRectangle& stage);
     size_t getNumClusters() const { return clusters.size(); }
+    /** Bounding boxes (chip pixels, clipped to the chip) of the clusters that
+     * were visible at the last updateClusterList(). */
+    std::vector<ofRectangle> getVisibleClusterBounds() const;
 
 private:
     Cluster * findClusterNear(const PolarityEvent& ev);
@@ -0,0 +1,147 @@
+#pragma once
+/// @file dvs_activity_gate.hpp
+/// @brief Skips NN inference when the event stream says nothing changed.
+///
+/// Once per update the main thread summarises the event packet into an
+/// ActivitySnapshot: valid event count, the fraction of a coarse grid the
+/// events cover, and the per-cell event histogram.  Each pipeline owns an
+/// ActivityGate that compares the snapshot with the one its last inference
+/// ran on.  A quiet scene (too few events, or too little coverage) gets one
+/// inference on the transition, so stale results are cleared, and none after
+/// that; an active scene is re-inferred when its histogram has moved enough
+/// or the last inference is older than refresh_ms.  A skipped frame reuses
+/// the previous result and costs neither the tensor build nor OnnxRunner.
+///
+/// The snapshot is taken from the events rather than from the built tensor
+/// so the decision comes before the tensor build and works the same for
+/// float32, float16 and binned inputs.
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <string>
+
+namespace dvs {
+
+/// Coarse statistics of one event packet, shared by all gates.
+struct ActivitySnapshot {
+    static constexpr int GW = 32, GH = 24;
+
+    size_t  events   = 0;       ///< valid events
+    float   coverage = 0.f;     ///< fraction of grid cells with at least one event
+    int64_t ts       = 0;       ///< newest event timestamp (us)
+    std::array<uint32_t, GW * GH> cells{};
+
+    /// Summarise `evs` (anything with .valid, .pos.x/.y and .timestamp).
+    template <class Events>
+    void build(const Events& evs, int sensorW, int sensorH) {
+        cells.fill(0);
+        events = 0;
+        ts = 0;
+        if (sensorW <= 0 || sensorH <= 0) { coverage = 0.f; return; }
+        const float fx = (float)GW / sensorW, fy = (float)GH / sensorH;
+        for (const auto& e : evs) {
+            if (!e.valid) continue;
+            const int cx = std::min(GW - 1, std::max(0, (int)(e.pos.x * fx)));
+            const int cy = std::min(GH - 1, std::max(0, (int)(e.pos.y * fy)));
+            cells[(size_t)cy * GW + cx]++;
+            events++;
+            ts = std::max<int64_t>(ts, e.timestamp);
+        }
+        int lit = 0;
+        for (uint32_t c : cells) lit += c > 0;
+        coverage = (float)lit / (GW * GH);
+    }
+};
+
+struct ActivityGateConfig {
+    bool  enabled      = true;
+    int   min_events   = 100;     ///< fewer valid events = quiet scene
+    float min_coverage = 0.005f;  ///< smaller fraction of grid cells = quiet scene
+    float min_change   = 0.1f;    ///< histogram distance (0..1) that triggers a re-run
+    float refresh_ms   = 1000.f;  ///< re-run an active scene at least this often
+};
+
+class ActivityGate {
+public:
+    ActivityGateConfig cfg;
+
+    /// Decide for one frame without changing the gate: true to run inference,
+    /// false to reuse the previous result.  A caller whose tensor build can
+    /// still decline (rate limit, not enough binned events) calls commit()
+    /// once the tensor exists and skip() on false.
+    bool wouldAdmit(const ActivitySnapshot& a) const {
+        if (!cfg.enabled || !has_ref_) return true;
+        if (quiet_(a)) return !ref_quiet_;        // once, to clear stale results
+        const bool stale = a.ts - ref_ts_ >= (int64_t)(cfg.refresh_ms * 1000.f)
+                        || a.ts < ref_ts_;
+        return ref_quiet_ || stale || change_(a) >= cfg.min_change;
+    }
+
+    /// Inference runs on `a`: it becomes the reference.
+    void commit(const ActivitySnapshot& a) {
+        count_(false);
+        has_ref_ = true;
+        ref_quiet_ = quiet_(a);
+        ref_ts_ = a.ts;
+        const float inv = a.events ? 1.f / a.events : 0.f;
+        for (size_t i = 0; i < ref_.size(); ++i) ref_[i] = a.cells[i] * inv;
+    }
+
+    /// The gate declined this frame (skip statistics only).
+    void skip() { count_(true); }
+
+    /// wouldAdmit() and commit() / skip() in one, for callers whose tensor
+    /// build always succeeds.
+    bool admit(const ActivitySnapshot& a) {
+        if (!wouldAdmit(a)) { skip(); return false; }
+        commit(a);
+        return true;
+    }
+
+    /// Forget the reference: the next frame is admitted (history cleared).
+    void reset() { has_ref_ = false; }
+
+    float    skipRate() const { return skip_ema_; }   ///< recent fraction of frames skipped
+    uint64_t skipped()  const { return skipped_; }
+    uint64_t offered()  const { return offered_; }
+
+    /// Compact readout for GUI display, e.g. "skip 85% (1234/1450)".
+    std::string summary() const {
+        return "skip " + std::to_string((int)std::lround(skip_ema_ * 100.f)) + "% ("
+             + std::to_string(skipped_) + "/" + std::to_string(offered_) + ")";
+    }
+
+private:
+    static constexpr float kEma = 0.05f;
+
+    bool quiet_(const ActivitySnapshot& a) const {
+        return a.events < (size_t)std::max(0, cfg.min_events) || a.coverage < cfg.min_coverage;
+    }
+
+    void count_(bool skipped) {
+        offered_++;
+        skipped_ += skipped;
+        skip_ema_ += kEma * ((skipped ? 1.f : 0.f) - skip_ema_);
+    }
+
+    /// Half the L1 distance between the normalised cell histograms (0..1).
+    float change_(const ActivitySnapshot& a) const {
+        const float inv = a.events ? 1.f / a.events : 0.f;
+        float d = 0.f;
+        for (size_t i = 0; i < ref_.size(); ++i) d += std::fabs(a.cells[i] * inv - ref_[i]);
+        return 0.5f * d;
+    }
+
+    std::array<float, ActivitySnapshot::GW * ActivitySnapshot::GH> ref_{};
+    bool    has_ref_   = false;
+    bool    ref_quiet_ = false;
+    int64_t ref_ts_    = 0;
+
+    uint64_t offered_ = 0, skipped_ = 0;
+    float    skip_ema_ = 0.f;
+};
+
+} // namespace dvs
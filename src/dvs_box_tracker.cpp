@@ -0,0 +1,179 @@
+#include "dvs_box_tracker.hpp"
+#include "ofxDVS.hpp" // for struct polarity
+
+#include <algorithm>
+#include <cmath>
+
+namespace dvs {
+
+// ---- Axis (constant-velocity Kalman, one coordinate) ----
+void BoxTracker::Axis::init(float pos, float pos_var, float vel_var) {
+    p = pos; v = 0.f;
+    P00 = pos_var; P01 = 0.f; P11 = vel_var;
+}
+
+void BoxTracker::Axis::predict(float dt, float q) {
+    p += v * dt;
+    // P = F P F^T + Q, F = [1 dt; 0 1], Q = q * [dt^3/3 dt^2/2; dt^2/2 dt]
+    const float dt2 = dt * dt;
+    P00 += dt * (2.f * P01 + dt * P11) + q * dt2 * dt / 3.f;
+    P01 += dt * P11 + q * dt2 * 0.5f;
+    P11 += q * dt;
+}
+
+void BoxTracker::Axis::correct(float z, float r) {
+    const float s  = P00 + r;
+    const float k0 = P00 / s, k1 = P01 / s;
+    const float e  = z - p;
+    p += k0 * e;
+    v += k1 * e;
+    P11 -= k1 * P01;
+    P01 -= k1 * P00;
+    P00 -= k0 * P00;
+}
+
+// ---- predict_ ----
+void BoxTracker::predict_(int64_t ts_us) {
+    if (ts_ == 0 || ts_us <= ts_) {
+        if (ts_ == 0) ts_ = ts_us;
+        return;
+    }
+    const float dt = (float)(ts_us - ts_) * 1e-6f;
+    const float q = cfg.accel_noise * cfg.accel_noise;
+    for (auto& t : tracks_) {
+        t.x.predict(dt, q);
+        t.y.predict(dt, q);
+    }
+    ts_ = ts_us;
+}
+
+// ---- update ----
+void BoxTracker::update(const std::vector<YoloDet>& dets, int64_t ts_us) {
+    predict_(ts_us);
+    const float lag = ts_ > ts_us ? (float)(ts_ - ts_us) * 1e-6f : 0.f;
+
+    // Greedy association: all same-class pairs above match_iou, best first
+    struct Pair { float iou; int t, d; };
+    std::vector<Pair> pairs;
+    for (int ti = 0; ti < (int)tracks_.size(); ++ti) {
+        const Track& t = tracks_[ti];
+        const ofRectangle tb(t.x.p - 0.5f * t.w, t.y.p - 0.5f * t.h, t.w, t.h);
+        for (int di = 0; di < (int)dets.size(); ++di) {
+            if (dets[di].cls != t.cls) continue;
+            ofRectangle db = dets[di].box;
+            db.x += t.x.v * lag;
+            db.y += t.y.v * lag;
+            const float iou = nn::rectIoU(tb, db);
+            if (iou >= cfg.match_iou) pairs.push_back({iou, ti, di});
+        }
+    }
+    std::sort(pairs.begin(), pairs.end(), [](const Pair& a, const Pair& b) { return a.iou > b.iou; });
+
+    std::vector<char> t_used(tracks_.size(), 0), d_used(dets.size(), 0);
+    const float r = cfg.det_noise_px * cfg.det_noise_px;
+    for (const auto& pr : pairs) {
+        if (t_used[pr.t] || d_used[pr.d]) continue;
+        t_used[pr.t] = d_used[pr.d] = 1;
+        Track& t = tracks_[pr.t];
+        const YoloDet& d = dets[pr.d];
+        const ofPoint c = d.box.getCenter();
+        t.x.correct(c.x + t.x.v * lag, r);
+        t.y.correct(c.y + t.y.v * lag, r);
+        t.w += cfg.size_alpha * (d.box.getWidth()  - t.w);
+        t.h += cfg.size_alpha * (d.box.getHeight() - t.h);
+        t.score = d.score;
+        t.hits++;
+        t.misses = 0;
+        t.seen_ts = ts_;
+    }
+
+    // Unmatched tracks age out; unmatched detections start new tracks
+    for (size_t ti = 0; ti < tracks_.size(); ++ti)
+        if (!t_used[ti]) tracks_[ti].misses++;
+    tracks_.erase(std::remove_if(tracks_.begin(), tracks_.end(),
+                                 [&](const Track& t) { return t.misses > cfg.max_misses; }),
+                  tracks_.end());
+
+    for (size_t di = 0; di < dets.size(); ++di) {
+        if (d_used[di]) continue;
+        const YoloDet& d = dets[di];
+        Track t;
+        t.id = next_id_++;
+        t.cls = d.cls;
+        t.score = d.score;
+        const ofPoint c = d.box.getCenter();
+        t.x.init(c.x, r, 100.f * 100.f);
+        t.y.init(c.y, r, 100.f * 100.f);
+        t.w = d.box.getWidth();
+        t.h = d.box.getHeight();
+        t.hits = 1;
+        t.seen_ts = ts_;
+        tracks_.push_back(t);
+    }
+}
+
+// ---- propagate ----
+void BoxTracker::propagate(const std::vector<polarity>& events, int64_t ts_us) {
+    predict_(ts_us);
+    if (tracks_.empty()) return;
+
+    // Event centroid inside each track's search window
+    const size_t n = tracks_.size();
+    sum_x_.assign(n, 0.0);
+    sum_y_.assign(n, 0.0);
+    count_.assign(n, 0);
+    std::vector<ofRectangle> win(n);
+    for (size_t k = 0; k < n; ++k) {
+        const Track& t = tracks_[k];
+        const float hw = 0.5f * t.w * (1.f + 2.f * cfg.search_margin);
+        const float hh = 0.5f * t.h * (1.f + 2.f * cfg.search_margin);
+        win[k].set(t.x.p - hw, t.y.p - hh, 2.f * hw, 2.f * hh);
+    }
+    for (const auto& e : events) {
+        if (!e.valid) continue;
+        const float ex = e.pos.x, ey = e.pos.y;
+        for (size_t k = 0; k < n; ++k) {
+            const ofRectangle& w = win[k];
+            if (ex < w.x || ey < w.y || ex >= w.x + w.width || ey >= w.y + w.height) continue;
+            sum_x_[k] += ex;
+            sum_y_[k] += ey;
+            count_[k]++;
+        }
+    }
+
+    const float r = cfg.event_noise_px * cfg.event_noise_px;
+    const int64_t max_coast_us = (int64_t)(cfg.max_coast_ms * 1000.f);
+    for (size_t k = 0; k < n; ++k) {
+        Track& t = tracks_[k];
+        if (count_[k] < cfg.min_events) continue;
+        t.x.correct((float)(sum_x_[k] / count_[k]), r);
+        t.y.correct((float)(sum_y_[k] / count_[k]), r);
+        t.seen_ts = ts_;
+    }
+    tracks_.erase(std::remove_if(tracks_.begin(), tracks_.end(),
+                                 [&](const Track& t) { return ts_ - t.seen_ts > max_coast_us; }),
+                  tracks_.end());
+}
+
+// ---- detections ----
+std::vector<YoloDet> BoxTracker::detections(int sensorW, int sensorH) const {
+    std::vector<YoloDet> out;
+    out.reserve(tracks_.size());
+    const ofRectangle sensor(0, 0, sensorW, sensorH);
+    for (const auto& t : tracks_) {
+        if (t.hits < cfg.min_hits && t.score < cfg.confirm_score) continue;
+        ofRectangle b(t.x.p - 0.5f * t.w, t.y.p - 0.5f * t.h, t.w, t.h);
+        b = b.getIntersection(sensor);
+        if (b.getWidth() <= 0 || b.getHeight() <= 0) continue;
+        out.push_back(YoloDet{b, t.score, t.cls, t.id});
+    }
+    return out;
+}
+
+// ---- clear ----
+void BoxTracker::clear() {
+    tracks_.clear();
+    ts_ = 0;
+}
+
+} // namespace dvs
@@ -0,0 +1,88 @@
+#pragma once
+/// @file dvs_box_tracker.hpp
+/// @brief Detect-then-track: carries YOLO boxes between detector runs.
+///
+/// The detector runs at a low cadence (every Nth image frame or on demand).
+/// In between, each track is predicted by a constant-velocity Kalman filter
+/// on its box centre and corrected by the centroid of the events that fall
+/// in and around the box, so boxes follow moving objects at event rate.
+/// Detector results are associated with the tracks by greedy per-class
+/// IoU; object ids persist across frames and detector runs.
+
+#include <vector>
+#include <cstdint>
+
+#include "ofMain.h"
+#include "dvs_yolo_pipeline.hpp"
+
+struct polarity;
+
+namespace dvs {
+
+struct BoxTrackerConfig {
+    float match_iou      = 0.3f;    ///< min IoU to associate a detection with a track
+    int   min_hits       = 2;       ///< detector hits before a track is shown...
+    float confirm_score  = 0.9f;    ///< ...unless a single detection is this confident
+    int   max_misses     = 2;       ///< detector runs a track may stay unmatched
+    float max_coast_ms   = 1000.f;  ///< drop a track after this long without events or detections
+    float search_margin  = 0.25f;   ///< event window: box grown by this fraction per side
+    int   min_events     = 20;      ///< events in the window needed to correct a track
+    float accel_noise    = 400.f;   ///< Kalman process noise (px/s^2)
+    float det_noise_px   = 2.f;     ///< detector centre noise (px)
+    float event_noise_px = 4.f;     ///< event-centroid noise (px)
+    float size_alpha     = 0.4f;    ///< box size EMA weight of a new detection
+};
+
+class BoxTracker {
+public:
+    /// Associate one detector result (sensor coordinates) with the tracks.
+    /// @param ts_us  event timestamp the detections were computed at; the
+    ///               boxes are shifted by the track velocity to the current
+    ///               tracker time to make up for inference latency
+    void update(const std::vector<YoloDet>& dets, int64_t ts_us);
+
+    /// Move the tracks with the events of one frame (call every frame).
+    void propagate(const std::vector<polarity>& events, int64_t ts_us);
+
+    /// Confirmed tracks as detections, with YoloDet::id set.
+    std::vector<YoloDet> detections(int sensorW, int sensorH) const;
+
+    size_t numTracks() const { return tracks_.size(); }
+
+    void clear();
+
+    BoxTrackerConfig cfg;
+
+private:
+    /// One axis of the constant-velocity Kalman filter: position, velocity
+    /// and their 2x2 covariance.
+    struct Axis {
+        float p = 0.f, v = 0.f;
+        float P00 = 1.f, P01 = 0.f, P11 = 1.f;
+        void init(float pos, float pos_var, float vel_var);
+        void predict(float dt, float q);
+        void correct(float z, float r);
+    };
+
+    struct Track {
+        int id = 0, cls = 0;
+        float score = 0.f;
+        Axis x, y;              ///< box centre
+        float w = 0.f, h = 0.f;
+        int hits = 0, misses = 0;
+        int64_t seen_ts = 0;    ///< last detection or event correction
+    };
+
+    /// Advance all tracks to ts_us (no-op for older timestamps).
+    void predict_(int64_t ts_us);
+
+    std::vector<Track> tracks_;
+    int next_id_ = 1;
+    int64_t ts_ = 0;            ///< time the tracks are predicted to
+
+    // propagate() scratch, one entry per track
+    std::vector<double> sum_x_, sum_y_;
+    std::vector<int> count_;
+};
+
+} // namespace dvs
@@ -0,0 +1,140 @@
+#pragma once
+/// @file dvs_calib_recorder.hpp
+/// @brief Dumps model input tensors for offline INT8 calibration.
+///
+/// While active, every Nth tensor handed to a model is written as raw
+/// little-endian float32 to <dir>/<tag>/NNNNNN.bin, with the tensor shape
+/// in <dir>/<tag>/shape.txt.  Replaying AEDAT recordings with the recorder
+/// on gives scripts/quantize_int8.py exactly the inputs the live pipelines
+/// produce (same VTEI / TSDT binning and letterboxing).
+///
+/// Stateful (SNN) models take their inputs as a sequence, so their tensors
+/// are recorded with a sequence id: every tensor is kept, and the indices
+/// at which the live model state was reset go to <dir>/<tag>/resets.txt,
+/// which lets the script replay the membrane state the live pipeline had.
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdio>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+
+#include "ofMain.h"
+#include "dvs_simd.hpp"
+
+namespace dvs {
+
+class CalibRecorder {
+public:
+    /// Start dumping into `dir` (created if missing).
+    /// @param max_per_model  stop recording a tag after this many tensors
+    /// @param every_n        keep one tensor out of every_n offered per tag
+    void start(const std::string& dir, int max_per_model = 500, int every_n = 5) {
+        dir_ = dir;
+        max_ = std::max(1, max_per_model);
+        every_n_ = std::max(1, every_n);
+        tags_.clear();
+        ofDirectory::createDirectory(dir_, false, true);
+        active_ = true;
+        ofLogNotice() << "[Calib] recording tensors to " << dir_
+                      << " (max " << max_ << " per model, every " << every_n_ << ")";
+    }
+
+    void stop() {
+        if (!active_) return;
+        active_ = false;
+        for (const auto& t : tags_)
+            ofLogNotice() << "[Calib] " << t.first << ": " << t.second.written << " tensors";
+    }
+
+    bool active() const { return active_; }
+
+    /// Number of tensors written for `tag` since start().
+    int count(const std::string& tag) const {
+        auto it = tags_.find(tag);
+        return it == tags_.end() ? 0 : it->second.written;
+    }
+
+    /// Offer one float32 tensor; written if recording and not full.
+    /// @param seq  stateful models: state generation the tensor runs with
+    ///             (e.g. the pipeline epoch).  The tag is then recorded
+    ///             without stride and a change of seq marks a reset.
+    ///             -1 = independent tensors.
+    void record(const std::string& tag, const float* data, size_t n,
+                const std::vector<int64_t>& shape, int64_t seq = -1) {
+        Tag* t = accept_(tag, shape, seq);
+        if (t) write_(tag, *t, data, n);
+    }
+
+    /// Same for an IEEE binary16 tensor (converted to float32 on disk).
+    void record(const std::string& tag, const uint16_t* data, size_t n,
+                const std::vector<int64_t>& shape, int64_t seq = -1) {
+        Tag* t = accept_(tag, shape, seq);
+        if (!t) return;
+        scratch_.resize(n);
+        simd::f16ToF32(data, scratch_.data(), n);
+        write_(tag, *t, scratch_.data(), n);
+    }
+
+private:
+    struct Tag {
+        int offered = 0;
+        int written = 0;
+        int64_t seq = -1;       ///< sequence id of the last written tensor
+        std::vector<int64_t> shape;
+    };
+
+    Tag* accept_(const std::string& tag, const std::vector<int64_t>& shape, int64_t seq) {
+        if (!active_) return nullptr;
+        Tag& t = tags_[tag];
+        if (t.written >= max_) return nullptr;
+        if (t.offered++ % (seq >= 0 ? 1 : every_n_) != 0) return nullptr;
+
+        if (t.shape != shape) {
+            if (!t.shape.empty()) {
+                ofLogWarning() << "[Calib] " << tag << " shape changed, stopped recording it";
+                t.written = max_;
+                return nullptr;
+            }
+            t.shape = shape;
+            ofDirectory::createDirectory(dir_ + "/" + tag, false, true);
+            std::ofstream f(dir_ + "/" + tag + "/shape.txt");
+            for (size_t i = 0; i < shape.size(); ++i) f << (i ? " " : "") << shape[i];
+            f << "\n";
+        }
+        if (seq >= 0) {
+            if (t.written > 0 && seq != t.seq) {
+                std::ofstream f(dir_ + "/" + tag + "/resets.txt", std::ios::app);
+                f << t.written << "\n";
+            }
+            t.seq = seq;
+        }
+        return &t;
+    }
+
+    void write_(const std::string& tag, Tag& t, const float* data, size_t n) {
+        std::ostringstream name;
+        name << dir_ << "/" << tag << "/" << std::setw(6) << std::setfill('0') << t.written << ".bin";
+        FILE* f = std::fopen(name.str().c_str(), "wb");
+        if (!f) {
+            ofLogError() << "[Calib] cannot write " << name.str();
+            t.written = max_;
+            return;
+        }
+        std::fwrite(data, sizeof(float), n, f);
+        std::fclose(f);
+        if (++t.written == max_)
+            ofLogNotice() << "[Calib] " << tag << ": " << max_ << " tensors, done";
+    }
+
+    bool active_ = false;
+    std::string dir_;
+    int max_ = 500;
+    int every_n_ = 5;
+    std::map<std::string, Tag> tags_;
+    std::vector<float> scratch_;
+};
+
+} // namespace dvs
@@ -0,0 +1,117 @@
+#include "dvs_event_recon.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace dvs {
+
+/// Values below this render as black (< 0.5 / 255 on the brightest channel).
+static constexpr float kVisibleEps = 1.0f / 512.0f;
+
+// ---- allocate ----
+void EventReconstruction::allocate(int W, int H) {
+    if (W == W_ && H == H_ && image_.isAllocated()) return;
+    W_ = W;
+    H_ = H;
+    const size_t n = (size_t)W * H;
+    value_.assign(n, 0.0f);
+    stamp_.assign(n, 0);
+    is_live_.assign(n, 0);
+    live_.clear();
+    live_.reserve(n / 8);
+    frame_ = 0;
+    image_.allocate(W, H, OF_IMAGE_COLOR);
+    image_.getPixels().set(0);
+}
+
+// ---- beginFrame ----
+void EventReconstruction::beginFrame(float decay, float contrib, int spread) {
+    ++frame_;
+    contrib_ = contrib;
+
+    if (decay != decay_) {
+        decay_ = decay;
+        // decay^k for every age at which a saturated pixel is still visible
+        const size_t max_len = 1 << 16;
+        decay_pow_.clear();
+        if (decay >= 1.0f) {
+            decay_pow_.assign(max_len, 1.0f);
+        } else {
+            for (float p = 1.0f; p >= kVisibleEps && decay_pow_.size() < max_len; p *= decay)
+                decay_pow_.push_back(p);
+        }
+    }
+
+    if (spread != spread_) {
+        spread_ = spread;
+        kernel_.clear();
+        for (int dy = -spread; dy <= spread; ++dy) {
+            for (int dx = -spread; dx <= spread; ++dx) {
+                float dist = std::sqrt((float)(dx * dx + dy * dy));
+                if (dist > spread) continue;
+                kernel_.push_back({dx, dy, 1.0f - dist / (spread + 1.0f)});
+            }
+        }
+    }
+}
+
+// ---- addEvent ----
+void EventReconstruction::addEvent(int cx, int cy, bool pol, float weight) {
+    const float val = (pol ? contrib_ : -contrib_) * weight;
+    const bool interior = cx >= spread_ && cx < W_ - spread_ &&
+                          cy >= spread_ && cy < H_ - spread_;
+    for (const Tap& t : kernel_) {
+        int px = cx + t.dx, py = cy + t.dy;
+        if (!interior && (px < 0 || px >= W_ || py < 0 || py >= H_)) continue;
+        int idx = py * W_ + px;
+        value_[idx] = std::clamp(decayed_(idx) + val * t.w, -1.0f, 1.0f);
+        stamp_[idx] = frame_;
+        if (!is_live_[idx]) {
+            is_live_[idx] = 1;
+            live_.push_back(idx);
+        }
+    }
+}
+
+// ---- render ----
+void EventReconstruction::render() {
+    unsigned char* raw = image_.getPixels().getData();
+    for (size_t i = 0; i < live_.size();) {
+        const int idx = live_[i];
+        const float v = decayed_(idx);
+        unsigned char* px = raw + (size_t)idx * 3;
+        if (std::abs(v) < kVisibleEps) {
+            px[0] = px[1] = px[2] = 0;
+            value_[idx] = 0.0f;
+            is_live_[idx] = 0;
+            live_[i] = live_.back();
+            live_.pop_back();
+            continue;
+        }
+        if (v > 0) {
+            px[0] = (unsigned char)(v * 255);
+            px[1] = (unsigned char)(v * 200);
+            px[2] = 0;
+        } else {
+            float a = -v;
+            px[0] = 0;
+            px[1] = (unsigned char)(a * 100);
+            px[2] = (unsigned char)(a * 255);
+        }
+        ++i;
+    }
+    image_.update();
+}
+
+// ---- clear ----
+void EventReconstruction::clear() {
+    std::fill(value_.begin(), value_.end(), 0.0f);
+    std::fill(is_live_.begin(), is_live_.end(), 0);
+    live_.clear();
+    if (image_.isAllocated()) {
+        image_.getPixels().set(0);
+        image_.update();
+    }
+}
+
+} // namespace dvs
@@ -0,0 +1,66 @@
+#pragma once
+/// @file dvs_event_recon.hpp
+/// @brief Event-driven image reconstruction with lazy per-pixel decay.
+///
+/// Each pixel stores its value together with the frame at which it was last
+/// written.  Decay is applied only when a pixel is touched by an event or
+/// read for colouring, using a power table decay^k, so the per-frame cost
+/// scales with event activity instead of sensor area.  Pixels that decay
+/// below visibility are painted black once and dropped from the live list.
+
+#include <vector>
+#include <cstdint>
+
+#include "ofMain.h"
+
+namespace dvs {
+
+class EventReconstruction {
+public:
+    /// Resize the internal maps and the output image (clears state on change).
+    void allocate(int W, int H);
+
+    /// Start a new frame with the current GUI parameters.
+    /// Rebuilds the decay table / spread kernel only when they change.
+    void beginFrame(float decay, float contrib, int spread);
+
+    /// Accumulate one event (ON adds, OFF subtracts) with spatial spread.
+    /// @param weight  multiplier on the contribution (e.g. event subsampling stride)
+    void addEvent(int x, int y, bool pol, float weight = 1.0f);
+
+    /// Re-colour only live pixels (yellow = ON, blue = OFF) and upload.
+    void render();
+
+    /// Forget all state and clear the image.
+    void clear();
+
+    ofImage& image() { return image_; }
+    const ofImage& image() const { return image_; }
+    size_t numLive() const { return live_.size(); }
+
+private:
+    /// Value of pixel idx decayed to the current frame.
+    float decayed_(int idx) const {
+        uint32_t age = frame_ - stamp_[idx];
+        return age < decay_pow_.size() ? value_[idx] * decay_pow_[age] : 0.0f;
+    }
+
+    struct Tap { int dx, dy; float w; };
+
+    int W_ = 0, H_ = 0;
+    std::vector<float>    value_;      ///< intensity at stamp_ time, -1..+1
+    std::vector<uint32_t> stamp_;      ///< frame of last write
+    std::vector<uint8_t>  is_live_;    ///< 1 if idx is in live_
+    std::vector<int>      live_;       ///< pixels with possibly visible value
+    uint32_t frame_ = 0;
+
+    std::vector<float> decay_pow_;     ///< decay^k until below visibility
+    std::vector<Tap>   kernel_;        ///< spread taps with distance weights
+    float decay_ = -1.0f;
+    int   spread_ = -1;
+    float contrib_ = 0.0f;
+
+    ofImage image_;                    ///< colour output (OF_IMAGE_COLOR)
+};
+
+} // namespace dvs
@@ -0,0 +1,117 @@
+#include "dvs_event_remap.hpp"
+
+#include "ofMain.h"
+#include <opencv2/core.hpp>
+#include <opencv2/calib3d.hpp>
+#include <cmath>
+
+namespace dvs {
+
+// ---- loadCalibration ----
+bool EventRemap::loadCalibration(const std::string& path) {
+    cv::FileStorage fs;
+    try {
+        if (!fs.open(path, cv::FileStorage::READ)) return false;
+    } catch (const cv::Exception& e) {
+        ofLogError() << "[EventRemap] Cannot parse " << path << ": " << e.what();
+        return false;
+    }
+
+    EventRemapConfig c;
+
+    cv::Mat K, D;
+    fs["camera_matrix"] >> K;
+    fs["distortion_coefficients"] >> D;
+    if (K.rows == 3 && K.cols == 3) {
+        K.convertTo(K, CV_64F);
+        c.fx = K.at<double>(0, 0);
+        c.fy = K.at<double>(1, 1);
+        c.cx = K.at<double>(0, 2);
+        c.cy = K.at<double>(1, 2);
+        if (!D.empty()) {
+            D.convertTo(D, CV_64F);
+            c.dist.assign(D.ptr<double>(), D.ptr<double>() + D.total());
+        }
+        c.undistort = (c.fx > 0 && c.fy > 0);
+    }
+
+    if (!fs["image_width"].empty())  fs["image_width"]  >> c.calib_width;
+    if (!fs["image_height"].empty()) fs["image_height"] >> c.calib_height;
+    if (!fs["rotation_deg"].empty()) fs["rotation_deg"] >> c.rotation_deg;
+    if (!fs["flip_x"].empty()) { int v = 0; fs["flip_x"] >> v; c.flip_x = (v != 0); }
+    if (!fs["flip_y"].empty()) { int v = 0; fs["flip_y"] >> v; c.flip_y = (v != 0); }
+
+    std::vector<int> crop;
+    if (!fs["crop"].empty()) fs["crop"] >> crop;
+    if (crop.size() == 4) {
+        c.crop_x = crop[0]; c.crop_y = crop[1];
+        c.crop_w = crop[2]; c.crop_h = crop[3];
+    }
+
+    cfg = c;
+    ofLogNotice() << "[EventRemap] Loaded " << path
+                  << " undistort=" << c.undistort
+                  << " rot=" << c.rotation_deg
+                  << " flip=" << c.flip_x << "," << c.flip_y
+                  << " crop=" << c.crop_w << "x" << c.crop_h;
+    return true;
+}
+
+// ---- build ----
+void EventRemap::build(int sensorW, int sensorH) {
+    W_ = sensorW;
+    H_ = sensorH;
+    num_valid_ = 0;
+    lut_.assign((size_t)W_ * H_, Entry{-1, -1});
+    if (W_ <= 0 || H_ <= 0) return;
+
+    // 1) undistorted pixel positions for every sensor pixel
+    std::vector<cv::Point2f> pts((size_t)W_ * H_);
+    for (int y = 0; y < H_; ++y)
+        for (int x = 0; x < W_; ++x)
+            pts[(size_t)y * W_ + x] = cv::Point2f((float)x, (float)y);
+
+    bool undistort = cfg.undistort;
+    if (undistort && cfg.calib_width > 0 && cfg.calib_height > 0 &&
+        (cfg.calib_width != W_ || cfg.calib_height != H_)) {
+        ofLogWarning() << "[EventRemap] Calibration is for " << cfg.calib_width << "x"
+                       << cfg.calib_height << ", sensor is " << W_ << "x" << H_
+                       << "; skipping undistortion";
+        undistort = false;
+    }
+    if (undistort) {
+        cv::Mat K = (cv::Mat_<double>(3, 3) << cfg.fx, 0, cfg.cx, 0, cfg.fy, cfg.cy, 0, 0, 1);
+        cv::Mat D = cfg.dist.empty() ? cv::Mat() : cv::Mat(cfg.dist, true);
+        std::vector<cv::Point2f> und;
+        // P = K keeps the result in pixel units of the same camera
+        cv::undistortPoints(pts, und, K, D, cv::noArray(), K);
+        pts.swap(und);
+    }
+
+    // 2) rotate about the canvas centre, flip, crop, quantise
+    const float th = cfg.rotation_deg * (float)M_PI / 180.0f;
+    const float cs = std::cos(th), sn = std::sin(th);
+    const float ox = 0.5f * (W_ - 1), oy = 0.5f * (H_ - 1);
+    const bool crop = cfg.crop_w > 0 && cfg.crop_h > 0;
+
+    for (size_t i = 0; i < pts.size(); ++i) {
+        float dx = pts[i].x - ox, dy = pts[i].y - oy;
+        float rx = ox + cs * dx - sn * dy;
+        float ry = oy + sn * dx + cs * dy;
+        if (cfg.flip_x) rx = (W_ - 1) - rx;
+        if (cfg.flip_y) ry = (H_ - 1) - ry;
+
+        int qx = (int)std::lround(rx), qy = (int)std::lround(ry);
+        if (qx < 0 || qx >= W_ || qy < 0 || qy >= H_) continue;
+        if (crop && (qx < cfg.crop_x || qx >= cfg.crop_x + cfg.crop_w ||
+                     qy < cfg.crop_y || qy >= cfg.crop_y + cfg.crop_h)) continue;
+
+        lut_[i] = Entry{(int16_t)qx, (int16_t)qy};
+        ++num_valid_;
+    }
+
+    ofLogNotice() << "[EventRemap] Built " << W_ << "x" << H_ << " LUT, "
+                  << num_valid_ << " valid pixels";
+}
+
+} // namespace dvs
@@ -0,0 +1,75 @@
+#pragma once
+/// @file dvs_event_remap.hpp
+/// @brief Per-pixel coordinate remap LUT (undistort, rotate, flip, crop).
+///
+/// Lens undistortion and mounting transforms are resolved once into a
+/// sensor-sized lookup table, so remapping an event in the ingestion path
+/// costs a single table read.  The output stays on the sensor canvas
+/// (sizeX x sizeY) so every downstream map keeps its size; pixels whose
+/// transformed position falls off the canvas or outside the crop are
+/// marked invalid and their events are dropped.
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace dvs {
+
+/// Calibration and mounting parameters for the remap.
+struct EventRemapConfig {
+    bool   undistort = false;          ///< apply lens undistortion
+    double fx = 0, fy = 0, cx = 0, cy = 0;  ///< pinhole intrinsics (pixels)
+    std::vector<double> dist;          ///< OpenCV distortion coefficients (k1,k2,p1,p2[,k3...])
+    int    calib_width = 0;            ///< image size the calibration was made at (0 = sensor)
+    int    calib_height = 0;
+
+    float  rotation_deg = 0.0f;        ///< rotation about the canvas centre (clockwise)
+    bool   flip_x = false;             ///< mirror horizontally (after rotation)
+    bool   flip_y = false;             ///< mirror vertically (after rotation)
+
+    int    crop_x = 0, crop_y = 0;     ///< crop rectangle in output coordinates
+    int    crop_w = 0, crop_h = 0;     ///< (0 = no crop)
+};
+
+/// Sensor-sized LUT mapping raw event coordinates to transformed ones.
+class EventRemap {
+public:
+    EventRemapConfig cfg;
+    bool enabled = false;
+
+    /// Load calibration from an OpenCV FileStorage file (yml/xml/json).
+    /// Recognised keys: camera_matrix, distortion_coefficients,
+    /// image_width, image_height, rotation_deg, flip_x, flip_y, crop [x,y,w,h].
+    /// @return true if the file was read.
+    bool loadCalibration(const std::string& path);
+
+    /// Rebuild the table for the given sensor size from cfg.
+    void build(int sensorW, int sensorH);
+
+    /// True if a table matching the sensor size is ready and remapping is on.
+    bool isActive(int sensorW, int sensorH) const {
+        return enabled && sensorW == W_ && sensorH == H_ && !lut_.empty();
+    }
+
+    /// Remap an event coordinate in place.
+    /// @return false if the event maps off-sensor / outside the crop.
+    bool apply(int& x, int& y) const {
+        if ((unsigned)x >= (unsigned)W_ || (unsigned)y >= (unsigned)H_) return false;
+        const Entry& m = lut_[(size_t)y * W_ + x];
+        if (m.x < 0) return false;
+        x = m.x;
+        y = m.y;
+        return true;
+    }
+
+    /// Number of sensor pixels that map to a valid output pixel.
+    int numValid() const { return num_valid_; }
+
+private:
+    struct Entry { int16_t x, y; };
+    std::vector<Entry> lut_;
+    int W_ = 0, H_ = 0;
+    int num_valid_ = 0;
+};
+
+} // namespace dvs
@@ -14,6 +14,22 @@ std::unique_ptr<ofxDatGui> createNNPanel(ofxDVS* dvs) {
     filt->addSlider("Hot Rate Threshold", 10, 5000, dvs->hot_rate_threshold);
     filt->addButton("Recalibrate Hot Pixels");
     filt->addSlider("BA Filter dt", 1, 100000, dvs->BAdeltaT);
+    filt->addSlider("Flicker Min (Hz)", 10, 200, dvs->flicker_min_hz);
+    filt->addSlider("Flicker Max (Hz)", 10, 200, dvs->flicker_max_hz);
+    filt->addSlider("Flicker Tolerance", 0.01, 0.5, dvs->flicker_tolerance);
+    filt->addSlider("Flicker Lock", 1, 16, dvs->flicker_lock_count);
+    dvs->flickerStatDisplay = filt->addTextInput("Flicker Removed", "0.0 %");
+    filt->addToggle("Event Remap", dvs->event_remap.enabled);
+    filt->addButton("Reload Remap");
+
+    // Load governor folder
+    auto gov = panel->addFolder(">> Load Governor");
+    gov->addToggle("ENABLE GOVERNOR", dvs->load_governor.cfg.enabled);
+    gov->addSlider("Budget (ms/frame)", 1, 50, dvs->load_governor.cfg.budget_ms);
+    gov->addSlider("Max Decimation", 1, 8, dvs->load_governor.cfg.max_decimation);
+    gov->addSlider("Max Event Stride", 1, 16, dvs->load_governor.cfg.max_stride);
+    dvs->governorCostDisplay = gov->addTextInput("Frame Cost", "");
+    dvs->governorSettingsDisplay = gov->addTextInput("Settings", "");
 
     // Video recording folder
     auto vid = panel->addFolder(">> Video Output");
@@ -31,6 +47,26 @@ std::unique_ptr<ofxDatGui> createNNPanel(ofxDVS* dvs) {
     nn_folder->addSlider("SMOOTH FRAMES", 1, 5, dvs->yolo_pipeline.cfg.smooth_frames);
     nn_folder->addSlider("VTEI Window (ms)", 5, 200, dvs->yolo_pipeline.cfg.vtei_win_ms);
     nn_folder->addButton("CLEAR HISTORY");
+    nn_folder->addToggle("YOLO LATEST WINS", dvs->yolo_worker.mode() == dvs::SubmitMode::LatestWins);
+    nn_folder->addToggle("TRACK BETWEEN DETECTIONS", dvs->yoloTrack);
+    nn_folder->addSlider("DETECT EVERY (frames)", 1, 30, dvs->yoloDetectEvery);
+    nn_folder->addButton("DETECT NOW");
+    dvs->yoloTrackerDisplay = nn_folder->addTextInput("YOLO Tracker", "");
+    dvs->yoloWorkerDisplay = nn_folder->addTextInput("YOLO Worker", "");
+    dvs->yoloModelDisplay  = nn_folder->addTextInput("YOLO Model", "");
+    nn_folder->addButton("RELOAD YOLO MODEL");
+    nn_folder->addButton("LOAD YOLO MODEL...");
+    nn_folder->addButton("BENCHMARK VTEI");
+    nn_folder->addButton("BENCHMARK FP16");
+    nn_folder->addButton("BENCHMARK CONCURRENT NN");
+    nn_folder->addButton("BENCHMARK YOLO BATCH");
+    nn_folder->addButton("BENCHMARK YOLO DECODE");
+    nn_folder->addButton("BENCHMARK NMS");
+    nn_folder->addToggle("RECORD CALIBRATION", false);
+    nn_folder->addToggle("ACTIVITY GATE", dvs->yolo_pipeline.gate.cfg.enabled);
+    nn_folder->addSlider("GATE MIN EVENTS", 0, 2000, dvs->yolo_pipeline.gate.cfg.min_events);
+    nn_folder->addSlider("GATE MIN CHANGE", 0.0, 1.0, dvs->yolo_pipeline.gate.cfg.min_change);
+    dvs->gateDisplay = nn_folder->addTextInput("NN Gate", "");
 
     // TSDT folder
     auto tsdt_folder = panel->addFolder(">> Neural Net (TSDT)");
@@ -42,6 +78,10 @@ std::unique_ptr<ofxDatGui> createNNPanel(ofxDVS* dvs) {
     tsdt_folder->addSlider("Confidence %", 0, 100, dvs->tsdt_pipeline.cfg.conf_threshold * 100.f);
     tsdt_folder->addSlider("Display (s)",  0.1, 5.0, dvs->tsdt_pipeline.cfg.display_timeout);
     tsdt_folder->addButton("SELFTEST (from file)");
+    dvs->tsdtWorkerDisplay = tsdt_folder->addTextInput("TSDT Worker", "");
+    dvs->tsdtModelDisplay  = tsdt_folder->addTextInput("TSDT Model", "");
+    tsdt_folder->addButton("RELOAD TSDT MODEL");
+    tsdt_folder->addButton("LOAD TSDT MODEL...");
 
     // TPDVSGesture folder
     auto tpg_folder = panel->addFolder(">> TPDVSGesture");
@@ -52,13 +92,34 @@ std::unique_ptr<ofxDatGui> createNNPanel(ofxDVS* dvs) {
     tpg_folder->addSlider("TPDVSGesture Confidence %", 0, 100, dvs->tpdvs_gesture_pipeline.cfg.conf_threshold * 100.f);
     tpg_folder->addSlider("TPDVSGesture Display (s)", 0.1, 5.0, dvs->tpdvs_gesture_pipeline.cfg.display_timeout);
     tpg_folder->addButton("TPDVSGesture CLEAR HISTORY");
+    dvs->tpdvsWorkerDisplay = tpg_folder->addTextInput("TPDVSGesture Worker", "");
+    dvs->tpdvsModelDisplay  = tpg_folder->addTextInput("TPDVSGesture Model", "");
+    tpg_folder->addButton("RELOAD TPDVSGesture MODEL");
+    tpg_folder->addButton("LOAD TPDVSGesture MODEL...");
+
+    // ROI folder: crop inference on the cluster tracker's visible clusters
+    auto roi_folder = panel->addFolder(">> ROI Crops");
+    roi_folder->addToggle("ENABLE ROI NN", dvs->roiEnabled);
+    roi_folder->addToggle("ROI MERGE CLUSTERS", dvs->roi_pipeline.cfg.merge);
+    roi_folder->addSlider("ROI CROP (px)", 16, 256, dvs->roi_pipeline.cfg.crop_px);
+    roi_folder->addSlider("ROI MAX CROPS", 1, 32, dvs->roi_pipeline.cfg.max_crops);
+    roi_folder->addSlider("ROI CONF THRESH", 0.0, 1.0, dvs->roi_pipeline.cfg.conf_thresh);
+    dvs->roiWorkerDisplay = roi_folder->addTextInput("ROI Worker", "");
+    dvs->roiModelDisplay  = roi_folder->addTextInput("ROI Model", "");
+    roi_folder->addButton("RELOAD ROI MODEL");
+    roi_folder->addButton("LOAD ROI MODEL...");
 
     panel->setPosition(270, 0);
 
     // Bind events using lambdas that capture `dvs`
-    panel->onToggleEvent([dvs](ofxDatGuiToggleEvent e) { onNNToggleEvent(e, dvs); });
+    panel->onToggleEvent([dvs](ofxDatGuiToggleEvent e) {
+        onFilterToggleEvent(e, dvs);
+        onGovernorToggleEvent(e, dvs);
+        onNNToggleEvent(e, dvs);
+    });
     panel->onSliderEvent([dvs](ofxDatGuiSliderEvent e) {
         onFilterSliderEvent(e, dvs);
+        onGovernorSliderEvent(e, dvs);
         onNNSliderEvent(e, dvs);
         onVideoSliderEvent(e, dvs);
     });
@@ -148,12 +209,50 @@ void onFilterSliderEvent(ofxDatGuiSliderEvent e, ofxDVS* dvs) {
         ofLogNotice() << "[HotPixel] Rate threshold set to " << dvs->hot_rate_threshold;
     } else if (n == "BA Filter dt") {
         dvs->changeBAdeltat(e.value);
+    } else if (n == "Flicker Min (Hz)") {
+        dvs->flicker_min_hz = e.value;
+    } else if (n == "Flicker Max (Hz)") {
+        dvs->flicker_max_hz = e.value;
+    } else if (n == "Flicker Tolerance") {
+        dvs->flicker_tolerance = e.value;
+    } else if (n == "Flicker Lock") {
+        dvs->flicker_lock_count = std::max(1, (int)std::round(e.value));
+    }
+}
+
+void onFilterToggleEvent(ofxDatGuiToggleEvent e, ofxDVS* dvs) {
+    if (e.target->getName() == "Event Remap") {
+        dvs->event_remap.enabled = e.target->getChecked();
+        ofLogNotice() << "[EventRemap] " << (dvs->event_remap.enabled ? "enabled" : "disabled");
     }
 }
 
 void onFilterButtonEvent(ofxDatGuiButtonEvent e, ofxDVS* dvs) {
     if (e.target->getName() == "Recalibrate Hot Pixels") {
         dvs->recalibrateHotPixels();
+    } else if (e.target->getName() == "Reload Remap") {
+        dvs->reloadEventRemap();
+    }
+}
+
+// ---- Load governor event handlers ----
+void onGovernorToggleEvent(ofxDatGuiToggleEvent e, ofxDVS* dvs) {
+    if (e.target->getName() == "ENABLE GOVERNOR") {
+        dvs->load_governor.cfg.enabled = e.target->getChecked();
+        if (!dvs->load_governor.cfg.enabled) dvs->load_governor.reset();
+        ofLogNotice() << "[Governor] " << (dvs->load_governor.cfg.enabled ? "enabled" : "disabled");
+    }
+}
+
+void onGovernorSliderEvent(ofxDatGuiSliderEvent e, ofxDVS* dvs) {
+    const std::string& n = e.target->getName();
+    auto& cfg = dvs->load_governor.cfg;
+    if (n == "Budget (ms/frame)") {
+        cfg.budget_ms = e.value;
+    } else if (n == "Max Decimation") {
+        cfg.max_decimation = std::max(1, (int)std::round(e.value));
+    } else if (n == "Max Event Stride") {
+        cfg.max_stride = std::max(1, (int)std::round(e.value));
     }
 }
 
@@ -169,6 +268,27 @@ void onNNToggleEvent(ofxDatGuiToggleEvent e, ofxDVS* dvs) {
         dvs->yolo_pipeline.cfg.draw = checked;
     } else if (name == "SHOW LABELS") {
         dvs->yolo_pipeline.cfg.show_labels = checked;
+    } else if (name == "RECORD CALIBRATION") {
+        if (checked) {
+            // Stateful models: start the recorded sequence from zero state
+            dvs->tsdt_pipeline.clearHistory();
+            dvs->tpdvs_gesture_pipeline.clearHistory();
+            dvs->calib_recorder.start(ofToDataPath("calib", true));
+        } else {
+            dvs->calib_recorder.stop();
+        }
+    } else if (name == "TRACK BETWEEN DETECTIONS") {
+        dvs->yoloTrack = checked;
+        dvs->yolo_pipeline.cfg.smooth = !checked;   // the tracker replaces smoothing
+        dvs->yolo_pipeline.clearHistory();
+        dvs->box_tracker.clear();
+        dvs->yoloDetectNow_ = true;
+    } else if (name == "ACTIVITY GATE") {
+        auto c = dvs->yolo_pipeline.gate.cfg;
+        c.enabled = checked;
+        dvs->setActivityGates(c);
+    } else if (name == "YOLO LATEST WINS") {
+        dvs->yolo_worker.setMode(checked ? dvs::SubmitMode::LatestWins : dvs::SubmitMode::DropIfBusy);
     } else if (name == "ENABLE TSDT") {
         dvs->tsdtEnabled = checked;
         if (!checked) dvs->tsdt_pipeline.clearHistory();
@@ -181,6 +301,13 @@ void onNNToggleEvent(ofxDatGuiToggleEvent e, ofxDVS* dvs) {
         ofLogNotice() << "TPDVSGesture " << (checked ? "enabled" : "disabled");
     } else if (name == "TPDVSGesture SHOW LABEL") {
         dvs->tpdvs_gesture_pipeline.cfg.show_label = checked;
+    } else if (name == "ENABLE ROI NN") {
+        dvs->roiEnabled = checked;
+        if (!checked) dvs->roi_pipeline.clearHistory();
+        if (checked && !dvs->rectangularClusterTrackerEnabled)
+            ofLogNotice() << "ROI NN crops the cluster tracker's clusters: enable the tracker too";
+    } else if (name == "ROI MERGE CLUSTERS") {
+        dvs->roi_pipeline.cfg.merge = checked;
     }
 }
 
@@ -193,6 +320,16 @@ void onNNSliderEvent(ofxDatGuiSliderEvent e, ofxDVS* dvs) {
         dvs->yolo_pipeline.cfg.iou_thresh = e.value;
     } else if (n == "SMOOTH FRAMES") {
         dvs->yolo_pipeline.cfg.smooth_frames = std::max(1, (int)std::round(e.value));
+    } else if (n == "GATE MIN EVENTS") {
+        auto c = dvs->yolo_pipeline.gate.cfg;
+        c.min_events = std::max(0, (int)std::round(e.value));
+        dvs->setActivityGates(c);
+    } else if (n == "GATE MIN CHANGE") {
+        auto c = dvs->yolo_pipeline.gate.cfg;
+        c.min_change = (float)e.value;
+        dvs->setActivityGates(c);
+    } else if (n == "DETECT EVERY (frames)") {
+        dvs->yoloDetectEvery = std::max(1, (int)std::round(e.value));
     } else if (n == "VTEI Window (ms)") {
         dvs->yolo_pipeline.cfg.vtei_win_ms = e.value;
         ofLogNotice() << "VTEI window: " << e.value << " ms";
@@ -214,18 +351,50 @@ void onNNSliderEvent(ofxDatGuiSliderEvent e, ofxDVS* dvs) {
         dvs->tpdvs_gesture_pipeline.cfg.conf_threshold = (float)e.value / 100.f;
     } else if (n == "TPDVSGesture Display (s)") {
         dvs->tpdvs_gesture_pipeline.cfg.display_timeout = (float)e.value;
+    } else if (n == "ROI CROP (px)") {
+        dvs->roi_pipeline.cfg.crop_px = std::max(1, (int)std::round(e.value));
+    } else if (n == "ROI MAX CROPS") {
+        dvs->roi_pipeline.cfg.max_crops = std::max(1, (int)std::round(e.value));
+    } else if (n == "ROI CONF THRESH") {
+        dvs->roi_pipeline.cfg.conf_thresh = e.value;
     }
 }
 
 void onNNButtonEvent(ofxDatGuiButtonEvent e, ofxDVS* dvs) {
     if (e.target->getName() == "CLEAR HISTORY") {
         dvs->yolo_pipeline.clearHistory();
+        dvs->box_tracker.clear();
         ofLogNotice() << "YOLO temporal history cleared.";
+    } else if (e.target->getName() == "DETECT NOW") {
+        dvs->yoloDetectNow_ = true;
+    } else if (e.target->getName() == "BENCHMARK VTEI") {
+        dvs::simd::benchmarkVTEI();
+    } else if (e.target->getName() == "BENCHMARK FP16") {
+        dvs::simd::benchmarkF16();
+    } else if (e.target->getName() == "BENCHMARK CONCURRENT NN") {
+        dvs->benchmarkInference();
+    } else if (e.target->getName() == "BENCHMARK YOLO BATCH") {
+        dvs->yolo_pipeline.benchmarkBatch();
+    } else if (e.target->getName() == "BENCHMARK YOLO DECODE") {
+        dvs->yolo_pipeline.benchmarkDecode();
+    } else if (e.target->getName() == "BENCHMARK NMS") {
+        dvs::nn::benchmarkNms(dvs->yolo_pipeline.cfg.iou_thresh);
     } else if (e.target->getName() == "SELFTEST (from file)") {
         dvs->tsdt_pipeline.debugFromFile(ofToDataPath("tsdt_input_fp32.bin", true));
     } else if (e.target->getName() == "TPDVSGesture CLEAR HISTORY") {
         dvs->tpdvs_gesture_pipeline.clearHistory();
         ofLogNotice() << "TPDVSGesture history cleared.";
+    } else {
+        // Model hot swap: "RELOAD <X> MODEL" / "LOAD <X> MODEL..."
+        const std::string name = e.target->getName();
+        for (const std::string which : {"YOLO", "TSDT", "TPDVSGesture", "ROI"}) {
+            if (name == "RELOAD " + which + " MODEL") {
+                dvs->reloadModel(which);
+            } else if (name == "LOAD " + which + " MODEL...") {
+                ofFileDialogResult result = ofSystemLoadDialog("Load " + which + " model (.onnx)");
+                if (result.bSuccess) dvs->reloadModel(which, result.getPath());
+            }
+        }
     }
 }
 
@@ -237,9 +406,11 @@ std::unique_ptr<ofxDatGui> createOptFlowPanel(ofxDVS* dvs) {
     auto f = panel->addFolder(">> Optical Flow");
     f->addToggle("DRAW FLOW", dvs->drawOptFlow);
     f->addSlider("FLOW DECAY",     0.80, 1.0,  dvs->optFlowDecay);
-    f->addSlider("FLOW RADIUS",    1,    5,    dvs->optFlowRadius);
+    f->addSlider("FLOW RADIUS",    1,    7,    dvs->optFlowRadius);
     f->addSlider("FLOW DT (ms)",   5,    200,  dvs->optFlowDt_us / 1000);
     f->addSlider("FLOW MAX SPEED", 10,   2000, dvs->optFlowMaxSpeed);
+    f->addToggle("INTEGRAL FLOW", dvs->optFlowIntegral);
+    f->addButton("BENCHMARK FLOW");
 
     auto r = panel->addFolder(">> Reconstruction");
     r->addToggle("RECON IMAGE", dvs->drawRecon);
@@ -251,6 +422,7 @@ std::unique_ptr<ofxDatGui> createOptFlowPanel(ofxDVS* dvs) {
 
     panel->onToggleEvent([dvs](ofxDatGuiToggleEvent e) { onOptFlowToggleEvent(e, dvs); });
     panel->onSliderEvent([dvs](ofxDatGuiSliderEvent e) { onOptFlowSliderEvent(e, dvs); });
+    panel->onButtonEvent([dvs](ofxDatGuiButtonEvent e) { onOptFlowButtonEvent(e, dvs); });
 
     return panel;
 }
@@ -260,6 +432,15 @@ void onOptFlowToggleEvent(ofxDatGuiToggleEvent e, ofxDVS* dvs) {
         dvs->drawOptFlow = e.target->getChecked();
     } else if (e.target->getName() == "RECON IMAGE") {
         dvs->drawRecon = e.target->getChecked();
+    } else if (e.target->getName() == "INTEGRAL FLOW") {
+        dvs->optFlowIntegral = e.target->getChecked();
+        ofLogNotice() << "Optical flow method: " << (dvs->optFlowIntegral ? "integral" : "plane fit");
+    }
+}
+
+void onOptFlowButtonEvent(ofxDatGuiButtonEvent e, ofxDVS* dvs) {
+    if (e.target->getName() == "BENCHMARK FLOW") {
+        dvs->benchmarkOpticalFlow();
     }
 }
 
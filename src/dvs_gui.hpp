@@ -26,15 +26,20 @@ std::unique_ptr<ofxDatGui> createTrackerPanel(ofxDVS* dvs);
 std::unique_ptr<ofxDatGui> createOptFlowPanel(ofxDVS* dvs);
 
 // Event handler callbacks (bound to the panels)
+void onFilterToggleEvent(ofxDatGuiToggleEvent e, ofxDVS* dvs);
 void onFilterSliderEvent(ofxDatGuiSliderEvent e, ofxDVS* dvs);
 void onFilterButtonEvent(ofxDatGuiButtonEvent e, ofxDVS* dvs);
 
+void onGovernorToggleEvent(ofxDatGuiToggleEvent e, ofxDVS* dvs);
+void onGovernorSliderEvent(ofxDatGuiSliderEvent e, ofxDVS* dvs);
+
 void onNNToggleEvent(ofxDatGuiToggleEvent e, ofxDVS* dvs);
 void onNNSliderEvent(ofxDatGuiSliderEvent e, ofxDVS* dvs);
 void onNNButtonEvent(ofxDatGuiButtonEvent e, ofxDVS* dvs);
 
 void onOptFlowToggleEvent(ofxDatGuiToggleEvent e, ofxDVS* dvs);
 void onOptFlowSliderEvent(ofxDatGuiSliderEvent e, ofxDVS* dvs);
+void onOptFlowButtonEvent(ofxDatGuiButtonEvent e, ofxDVS* dvs);
 
 void onTrackerToggleEvent(ofxDatGuiToggleEvent e, ofxDVS* dvs);
 void onTrackerSliderEvent(ofxDatGuiSliderEvent e, ofxDVS* dvs);
@@ -6,22 +6,57 @@
 /// The main thread builds input tensors and submits jobs; the worker thread
 /// runs ONNX inference and writes results under a mutex.  The main thread
 /// reads the last completed result for drawing (never blocks on ONNX).
+///
+/// Two submission modes:
+///  - DropIfBusy: a job submitted while another is queued or running is
+///    dropped (stateful models that must see every accepted input).
+///  - LatestWins: a one-slot mailbox; a newer submission replaces the job
+///    still waiting in it, so the next run always uses the freshest input.
+///
+/// Every result carries a Stamp (event time and wall times of its input) and
+/// the worker keeps Stats for tuning the submit cadence.
 
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
 
 namespace dvs {
 
+enum class SubmitMode { DropIfBusy = 0, LatestWins = 1 };
+
+/// Latency / throughput counters of an InferenceWorker (EMA over completed jobs).
+struct WorkerStats {
+    double   queue_wait_ms = 0.0;  ///< submit -> start
+    double   run_ms        = 0.0;  ///< start -> finish
+    double   result_age_ms = 0.0;  ///< now - submit time of the last result
+    int64_t  result_event_ts = 0;  ///< event time of the last result's input
+    uint64_t submitted = 0;
+    uint64_t dropped   = 0;        ///< rejected (DropIfBusy) or replaced (LatestWins)
+    uint64_t completed = 0;
+};
+
 /// Generic asynchronous inference worker.
 /// ResultT must be default-constructible and move-assignable.
 template <typename ResultT>
 class InferenceWorker {
 public:
     using JobFn = std::function<ResultT()>;
+    using Clock = std::chrono::steady_clock;
+
+    /// Provenance of a result.
+    struct Stamp {
+        int64_t event_ts = 0;          ///< event timestamp (us) of the input
+        Clock::time_point submitted;   ///< wall time the input was submitted
+        Clock::time_point started;     ///< wall time the job started running
+        Clock::time_point finished;    ///< wall time the result was published
+    };
+
+    using Stats = WorkerStats;
 
     InferenceWorker() = default;
 
@@ -34,23 +69,39 @@ public:
         thread_ = std::thread(&InferenceWorker::loop_, this);
     }
 
-    /// Submit a job.  If the worker is still busy with the previous job,
-    /// the submission is silently dropped (skip frame rather than block).
+    void setMode(SubmitMode m) { mode_ = m; }
+    SubmitMode mode() const { return mode_; }
+
+    /// Submit a job built from input with event time `event_ts` (us).
+    /// DropIfBusy: dropped if a job is queued or running.
+    /// LatestWins: replaces a job still waiting in the mailbox.
     /// @return true if the job was accepted, false if dropped.
-    bool submit(JobFn job) {
+    bool submit(JobFn job, int64_t event_ts = 0) {
         if (!running_) return false;
         {
             std::lock_guard<std::mutex> lk(mu_);
-            if (busy_) return false;  // previous job still running
+            ++submitted_;
+            if (mode_ == SubmitMode::DropIfBusy) {
+                if (busy_ || has_pending_) { ++dropped_; return false; }
+            } else if (has_pending_) {
+                ++dropped_;  // superseded before it ran
+            }
             pending_ = std::move(job);
+            pending_stamp_ = Stamp{};
+            pending_stamp_.event_ts  = event_ts;
+            pending_stamp_.submitted = Clock::now();
             has_pending_ = true;
         }
         cv_.notify_one();
         return true;
     }
 
-    /// Check whether the worker is currently running a job.
-    bool isBusy() const { return busy_.load(); }
+    /// Check whether the worker has a job queued or running (a DropIfBusy
+    /// submission would be dropped).
+    bool isBusy() const {
+        std::lock_guard<std::mutex> lk(mu_);
+        return busy_ || has_pending_;
+    }
 
     /// Read the last completed result (thread-safe).
     ResultT lastResult() const {
@@ -58,9 +109,43 @@ public:
         return result_;
     }
 
+    /// Stamp of the last completed result.
+    Stamp lastStamp() const {
+        std::lock_guard<std::mutex> lk(result_mu_);
+        return stamp_;
+    }
+
     /// Check if at least one result has been produced.
     bool hasResult() const { return has_result_.load(); }
 
+    /// Copy out the newest result if it has not been taken yet (thread-safe).
+    /// @return true if `out` was written.
+    bool takeResult(ResultT& out) {
+        std::lock_guard<std::mutex> lk(result_mu_);
+        if (!fresh_) return false;
+        out = result_;
+        fresh_ = false;
+        return true;
+    }
+
+    /// Snapshot of the latency counters.
+    Stats stats() const {
+        Stats s;
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            s.submitted = submitted_;
+            s.dropped   = dropped_;
+        }
+        std::lock_guard<std::mutex> lk(result_mu_);
+        s.queue_wait_ms   = wait_ema_ms_;
+        s.run_ms          = run_ema_ms_;
+        s.completed       = completed_;
+        s.result_event_ts = stamp_.event_ts;
+        if (completed_ > 0)
+            s.result_age_ms = ms_(stamp_.submitted, Clock::now());
+        return s;
+    }
+
     /// Stop the worker thread and join.
     void stop() {
         if (!running_) return;
@@ -73,17 +158,24 @@ public:
     }
 
 private:
+    static double ms_(Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    }
+
     void loop_() {
         while (true) {
             JobFn job;
+            Stamp st;
             {
                 std::unique_lock<std::mutex> lk(mu_);
                 cv_.wait(lk, [&] { return has_pending_ || !running_; });
                 if (!running_ && !has_pending_) break;
                 job = std::move(pending_);
+                st = pending_stamp_;
                 has_pending_ = false;
                 busy_ = true;
             }
+            st.started = Clock::now();
 
             ResultT r;
             try {
@@ -97,18 +189,28 @@ private:
                 busy_ = false;
                 continue;
             }
+            st.finished = Clock::now();
 
             {
                 std::lock_guard<std::mutex> lk(result_mu_);
                 result_ = std::move(r);
+                stamp_ = st;
                 has_result_ = true;
+                fresh_ = true;
+
+                const double a = completed_ == 0 ? 1.0 : kEma;
+                wait_ema_ms_ += a * (ms_(st.submitted, st.started) - wait_ema_ms_);
+                run_ema_ms_  += a * (ms_(st.started, st.finished) - run_ema_ms_);
+                ++completed_;
             }
             busy_ = false;
         }
     }
 
+    static constexpr double kEma = 0.1;
+
     std::thread thread_;
-    std::mutex mu_;
+    mutable std::mutex mu_;
     mutable std::mutex result_mu_;
     std::condition_variable cv_;
 
@@ -116,9 +218,21 @@ private:
     std::atomic<bool> busy_{false};
     std::atomic<bool> has_result_{false};
     bool has_pending_ = false;
+    SubmitMode mode_ = SubmitMode::DropIfBusy;
 
+    // Guarded by mu_
     JobFn pending_;
+    Stamp pending_stamp_;
+    uint64_t submitted_ = 0;
+    uint64_t dropped_   = 0;
+
+    // Guarded by result_mu_
     ResultT result_;
+    Stamp stamp_;
+    bool fresh_ = false;    ///< result_ not yet taken
+    uint64_t completed_ = 0;
+    double wait_ema_ms_ = 0.0;
+    double run_ema_ms_  = 0.0;
 };
 
 } // namespace dvs
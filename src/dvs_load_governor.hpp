@@ -0,0 +1,116 @@
+#pragma once
+/// @file dvs_load_governor.hpp
+/// @brief Feedback controller that holds per-frame processing cost within a budget.
+///
+/// The main thread brackets ofxDVS::update() with beginFrame()/endFrame().
+/// The measured cost is smoothed and compared against the budget; the
+/// relative error is integrated into a single "pressure" value in [0, 1].
+/// Pressure is mapped onto the filter knobs in stages, cheapest-to-lose
+/// first: flow/recon event subsampling, then BA filter window and
+/// refractory period, and finally spatial decimation of the event stream.
+
+#include <chrono>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+namespace dvs {
+
+struct LoadGovernorConfig {
+    bool  enabled = false;
+    float budget_ms = 12.0f;        ///< target update() cost per frame
+    float ema_alpha = 0.2f;         ///< smoothing of the measured cost
+    float gain = 0.25f;             ///< pressure change per unit of relative error
+    float min_ba_scale = 0.1f;      ///< BAdeltaT multiplier at full pressure
+    float max_refrac_scale = 8.0f;  ///< refractory multiplier at full pressure
+    int   max_decimation = 4;       ///< spatial block size at full pressure
+    int   max_stride = 8;           ///< flow/recon event stride at full pressure
+};
+
+/// Effective knob values chosen by the governor for the next frame.
+struct LoadSettings {
+    float ba_scale = 1.0f;      ///< multiply BAdeltaT
+    float refrac_scale = 1.0f;  ///< multiply hot_refrac_us
+    int   decimation = 1;       ///< keep one event per NxN block per frame
+    int   stride = 1;           ///< flow/recon process every Nth event
+};
+
+class LoadGovernor {
+public:
+    LoadGovernorConfig cfg;
+
+    /// Mark the start of a frame's processing.
+    void beginFrame() { t0_ = std::chrono::steady_clock::now(); }
+
+    /// Mark the end of a frame's processing and update the settings
+    /// used by the next frame.
+    void endFrame() {
+        const float ms = std::chrono::duration<float, std::milli>(
+            std::chrono::steady_clock::now() - t0_).count();
+        cost_ema_ms_ = (cost_ema_ms_ <= 0.0f)
+            ? ms : (1.0f - cfg.ema_alpha) * cost_ema_ms_ + cfg.ema_alpha * ms;
+        last_ms_ = ms;
+
+        if (!cfg.enabled) {
+            pressure_ = 0.0f;
+            settings_ = LoadSettings{};
+            return;
+        }
+
+        const float budget = std::max(0.1f, cfg.budget_ms);
+        const float err = (cost_ema_ms_ - budget) / budget;
+        pressure_ = std::clamp(pressure_ + cfg.gain * std::clamp(err, -1.0f, 1.0f), 0.0f, 1.0f);
+        settings_ = mapPressure_(pressure_);
+    }
+
+    const LoadSettings& settings() const { return settings_; }
+    float pressure() const { return pressure_; }
+    float costMs() const { return cost_ema_ms_; }
+    float lastCostMs() const { return last_ms_; }
+
+    void reset() {
+        pressure_ = 0.0f;
+        cost_ema_ms_ = 0.0f;
+        last_ms_ = 0.0f;
+        settings_ = LoadSettings{};
+    }
+
+    /// Compact description of the current settings for GUI display.
+    std::string summary() const {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(2)
+           << "BA x" << settings_.ba_scale
+           << " RF x" << std::setprecision(1) << settings_.refrac_scale
+           << " D" << settings_.decimation
+           << " S" << settings_.stride;
+        return ss.str();
+    }
+
+private:
+    /// Linear ramp of p over [lo, hi] to [0, 1].
+    static float ramp_(float p, float lo, float hi) {
+        return std::clamp((p - lo) / (hi - lo), 0.0f, 1.0f);
+    }
+
+    LoadSettings mapPressure_(float p) const {
+        LoadSettings s;
+        const float r_stride = ramp_(p, 0.0f, 0.5f);
+        const float r_filter = ramp_(p, 0.25f, 0.75f);
+        const float r_decim  = ramp_(p, 0.5f, 1.0f);
+        s.stride       = 1 + (int)std::lround(r_stride * (std::max(1, cfg.max_stride) - 1));
+        s.ba_scale     = 1.0f + r_filter * (cfg.min_ba_scale - 1.0f);
+        s.refrac_scale = 1.0f + r_filter * (cfg.max_refrac_scale - 1.0f);
+        s.decimation   = 1 + (int)std::lround(r_decim * (std::max(1, cfg.max_decimation) - 1));
+        return s;
+    }
+
+    std::chrono::steady_clock::time_point t0_ = std::chrono::steady_clock::now();
+    float cost_ema_ms_ = 0.0f;
+    float last_ms_ = 0.0f;
+    float pressure_ = 0.0f;
+    LoadSettings settings_;
+};
+
+} // namespace dvs
@@ -0,0 +1,75 @@
+#pragma once
+/// @file dvs_model_loader.hpp
+/// @brief Background loading of an OnnxRunner for hot-swappable pipelines.
+///
+/// Session creation (graph optimization, weight prepacking, warm-up) runs on
+/// a std::async thread; the owning pipeline polls from the main thread and
+/// swaps the finished runner in when its inference worker is idle, so the
+/// viewer keeps running while models load.  Destroying a loader with a
+/// load in flight blocks until it finishes (std::async future).
+
+#include <future>
+#include <memory>
+#include <string>
+#include <chrono>
+
+#include "ofMain.h"
+#include "onnx_run.hpp"
+
+namespace dvs {
+
+enum class LoadState { Empty = 0, Loading, Ready, Failed };
+
+inline const char* loadStateName(LoadState s) {
+    switch (s) {
+        case LoadState::Loading: return "loading";
+        case LoadState::Ready:   return "ready";
+        case LoadState::Failed:  return "failed";
+        default:                 return "no model";
+    }
+}
+
+class ModelLoader {
+public:
+    /// Start loading `cfg.model_path` in the background.
+    /// @return false if a load is already in flight.
+    bool start(const OnnxRunner::Config& cfg) {
+        if (busy()) return false;
+        path_ = cfg.model_path;
+        error_.clear();
+        fut_ = std::async(std::launch::async, [cfg]() {
+            auto r = std::make_unique<OnnxRunner>(cfg);
+            r->load();
+            return r;
+        });
+        return true;
+    }
+
+    /// A load is in flight (not yet taken).
+    bool busy() const { return fut_.valid(); }
+
+    /// Non-blocking: the loaded runner once the load has finished, else
+    /// nullptr.  On failure returns nullptr and sets error().
+    std::unique_ptr<OnnxRunner> take() {
+        if (!fut_.valid() ||
+            fut_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return nullptr;
+        try {
+            return fut_.get();
+        } catch (const std::exception& e) {
+            error_ = e.what();
+            if (error_.empty()) error_ = "unknown error";
+        }
+        return nullptr;
+    }
+
+    const std::string& path()  const { return path_; }
+    const std::string& error() const { return error_; }
+
+private:
+    std::future<std::unique_ptr<OnnxRunner>> fut_;
+    std::string path_;
+    std::string error_;
+};
+
+} // namespace dvs
@@ -7,8 +7,13 @@
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <chrono>
 
 #include "ofMain.h"
+#include "dvs_simd.hpp"
 
 namespace dvs { namespace nn {
 
@@ -40,86 +45,323 @@ inline float IoU(const Det& a, const Det& b) {
     return inter / std::max(1e-6f, areaA + areaB - inter);
 }
 
-/// Greedy non-maximum suppression, sorted by score descending.
-inline std::vector<Det> nms(std::vector<Det> dets, float iou_thresh) {
-    std::vector<Det> keep;
-    std::sort(dets.begin(), dets.end(),
-              [](const Det& a, const Det& b) { return a.score > b.score; });
-    std::vector<char> removed(dets.size(), 0);
+/// Reusable state for nmsInPlace(): a uniform grid over the candidates'
+/// extent, each cell listing the kept boxes that touch it.
+struct NmsWorkspace {
+    static constexpr int G = 16;            ///< grid is G x G cells
+    std::vector<std::vector<int>> cells;
+};
+
+/// Class-aware greedy non-maximum suppression, in place.
+///
+/// Candidates are visited by descending score; a box is kept unless it
+/// overlaps (IoU > iou_thresh) an already kept box of the same class.
+/// Kept boxes are registered in the grid cells they cover, so each
+/// candidate is only tested against kept boxes near it (cost ~ n * local
+/// kept, instead of n^2).  Result is identical to the textbook greedy NMS
+/// run per class.
+///
+/// @param dets   candidates; on return, the kept boxes sorted by score
+/// @param top_k  if > 0, only the top_k highest-scoring candidates are
+///               considered (bounds the cost at very low thresholds)
+inline void nmsInPlace(std::vector<Det>& dets, float iou_thresh, NmsWorkspace& ws,
+                       size_t top_k = 0)
+{
+    auto by_score = [](const Det& a, const Det& b) { return a.score > b.score; };
+    if (top_k > 0 && dets.size() > top_k) {
+        std::nth_element(dets.begin(), dets.begin() + top_k, dets.end(), by_score);
+        dets.resize(top_k);
+    }
+    std::sort(dets.begin(), dets.end(), by_score);
+    if (dets.size() < 2) return;
+
+    float minx = dets[0].x1, miny = dets[0].y1, maxx = dets[0].x2, maxy = dets[0].y2;
+    for (const auto& d : dets) {
+        minx = std::min(minx, d.x1); miny = std::min(miny, d.y1);
+        maxx = std::max(maxx, d.x2); maxy = std::max(maxy, d.y2);
+    }
+    const int G = NmsWorkspace::G;
+    const float inv_cw = G / std::max(1e-3f, maxx - minx);
+    const float inv_ch = G / std::max(1e-3f, maxy - miny);
+    auto cell = [G](float v, float lo, float inv) {
+        return std::min(G - 1, std::max(0, (int)((v - lo) * inv)));
+    };
+
+    ws.cells.resize((size_t)G * G);
+    for (auto& c : ws.cells) c.clear();
+
+    size_t n_keep = 0;   // kept boxes are compacted to dets[0 .. n_keep)
     for (size_t i = 0; i < dets.size(); ++i) {
-        if (removed[i]) continue;
-        keep.push_back(dets[i]);
-        for (size_t j = i + 1; j < dets.size(); ++j) {
-            if (!removed[j] && IoU(dets[i], dets[j]) > iou_thresh)
-                removed[j] = 1;
+        const Det d = dets[i];
+        const int cx0 = cell(d.x1, minx, inv_cw), cx1 = cell(d.x2, minx, inv_cw);
+        const int cy0 = cell(d.y1, miny, inv_ch), cy1 = cell(d.y2, miny, inv_ch);
+
+        bool suppressed = false;
+        for (int cy = cy0; cy <= cy1 && !suppressed; ++cy)
+            for (int cx = cx0; cx <= cx1 && !suppressed; ++cx)
+                for (int k : ws.cells[(size_t)cy * G + cx])
+                    if (dets[k].cls == d.cls && IoU(dets[k], d) > iou_thresh) { suppressed = true; break; }
+        if (suppressed) continue;
+
+        dets[n_keep] = d;
+        for (int cy = cy0; cy <= cy1; ++cy)
+            for (int cx = cx0; cx <= cx1; ++cx)
+                ws.cells[(size_t)cy * G + cx].push_back((int)n_keep);
+        ++n_keep;
+    }
+    dets.resize(n_keep);
+}
+
+/// Convenience form of nmsInPlace() (allocates; prefer the in-place one
+/// on per-frame paths).
+inline std::vector<Det> nms(std::vector<Det> dets, float iou_thresh) {
+    NmsWorkspace ws;
+    nmsInPlace(dets, iou_thresh, ws);
+    return dets;
+}
+
+/// Time nmsInPlace() against the O(n^2) per-class greedy reference on
+/// random boxes in a 352x288 frame (n = 250 .. 8000) and log candidates/us.
+inline void benchmarkNms(float iou_thresh = 0.45f, int iters = 20) {
+    auto reference = [](std::vector<Det> dets, float thr) {
+        std::sort(dets.begin(), dets.end(),
+                  [](const Det& a, const Det& b) { return a.score > b.score; });
+        std::vector<Det> keep;
+        std::vector<char> removed(dets.size(), 0);
+        for (size_t i = 0; i < dets.size(); ++i) {
+            if (removed[i]) continue;
+            keep.push_back(dets[i]);
+            for (size_t j = i + 1; j < dets.size(); ++j)
+                if (!removed[j] && dets[j].cls == dets[i].cls && IoU(dets[i], dets[j]) > thr)
+                    removed[j] = 1;
         }
+        return keep;
+    };
+
+    NmsWorkspace ws;
+    std::vector<Det> work;
+    uint32_t seed = 1234;
+    auto rnd = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) * (1.f / 16777216.f); };
+    for (int n : {250, 1000, 4000, 8000}) {
+        // Dense heads: many jittered boxes per object, 24 objects
+        std::vector<Det> cand(n);
+        for (int i = 0; i < n; ++i) {
+            const int o = i % 24;
+            const float ox = 30.f + 292.f * (o % 6) / 5.f, oy = 30.f + 228.f * (o / 6) / 3.f;
+            const float ow = 20.f + 2.f * o, oh = 40.f + 3.f * o;
+            const float w = ow * (0.85f + 0.3f * rnd()), h = oh * (0.85f + 0.3f * rnd());
+            const float cx = ox + 0.3f * ow * (rnd() - 0.5f), cy = oy + 0.3f * oh * (rnd() - 0.5f);
+            cand[i] = Det{cx - 0.5f*w, cy - 0.5f*h, cx + 0.5f*w, cy + 0.5f*h, rnd(), o & 1};
+        }
+
+        size_t n_ref = 0, n_new = 0;
+        double us_ref = 0.0, us_new = 0.0;
+        for (int it = 0; it < iters; ++it) {
+            auto t0 = std::chrono::steady_clock::now();
+            n_ref = reference(cand, iou_thresh).size();
+            auto t1 = std::chrono::steady_clock::now();
+            work.assign(cand.begin(), cand.end());
+            nmsInPlace(work, iou_thresh, ws);
+            auto t2 = std::chrono::steady_clock::now();
+            n_new = work.size();
+            us_ref += std::chrono::duration<double, std::micro>(t1 - t0).count();
+            us_new += std::chrono::duration<double, std::micro>(t2 - t1).count();
+        }
+        ofLogNotice() << "[NMS bench] " << n << " candidates -> " << n_new << " kept: "
+                      << "greedy " << n * iters / us_ref << " cand/us, "
+                      << "binned " << n * iters / us_new << " cand/us"
+                      << (n_ref == n_new ? "" : "  MISMATCH");
     }
-    return keep;
 }
 
 // ---------------------------------------------------------------------------
 // Letterbox transforms
 // ---------------------------------------------------------------------------
 
-/// Nearest-neighbour letterbox for CHW float buffers.
-/// Resizes (C, Hs, Ws) -> (C, Hd, Wd) preserving aspect ratio,
-/// padding with zeros.  Returns the resulting buffer and writes
-/// back the computed `scale`, `padx`, `pady`.
-inline std::vector<float> letterboxCHW(
-    const std::vector<float>& src,
-    int C, int Hs, int Ws,
-    int Hd, int Wd,
+/// Compute letterbox scale and padding without actually transforming data.
+inline void letterboxParams(
+    int Ws, int Hs, int Wd, int Hd,
     float& scale, int& padx, int& pady)
 {
-    std::vector<float> dst((size_t)C * Hd * Wd, 0.0f);
     scale = std::min((float)Wd / (float)Ws, (float)Hd / (float)Hs);
     const int newW = (int)std::round(Ws * scale);
     const int newH = (int)std::round(Hs * scale);
     padx = (Wd - newW) / 2;
     pady = (Hd - newH) / 2;
+}
+
+/// Resampling filter of a ResamplePlan.
+enum class ResampleMode {
+    Nearest,   ///< floor(x / scale), as the original letterbox
+    Area,      ///< box filter weighted by pixel overlap (cv::INTER_AREA when shrinking)
+    Bilinear   ///< 2x2 taps, pixel-centre aligned (cv::INTER_LINEAR)
+};
+
+/// Precomputed separable resampling from a (Ws x Hs) plane into a
+/// (Wd x Hd) one, either letterboxed (uniform scale, centred, padding left
+/// untouched) or stretched to the full destination.
+///
+/// Every output column and row gets a fixed number of (source index,
+/// weight) taps, resolved once in ensure().  run() then works a channel at
+/// a time and a row at a time: the source rows of an output row are summed
+/// into a contiguous row buffer (simd::weightedSum; skipped when the row
+/// has a single unit tap), then gathered through the column taps
+/// (simd::gatherWeighted).  No per-pixel division or floor.
+///
+/// A plan is rebuilt only when its sizes or mode change, so a pipeline can
+/// call ensure() every frame.  run()/row() use an internal row buffer: one
+/// thread per plan.
+class ResamplePlan {
+public:
+    /// (Re)build for the given geometry; no-op when unchanged.
+    /// @return true if the plan was rebuilt.
+    bool ensure(int Ws, int Hs, int Wd, int Hd, ResampleMode mode, bool letterbox = true) {
+        if (Ws == Ws_ && Hs == Hs_ && Wd == Wd_ && Hd == Hd_ && mode == mode_ && letterbox == letterbox_)
+            return false;
+        Ws_ = Ws; Hs_ = Hs; Wd_ = Wd; Hd_ = Hd; mode_ = mode; letterbox_ = letterbox;
+
+        float sx, sy;
+        if (letterbox) {
+            letterboxParams(Ws, Hs, Wd, Hd, scale_, padx_, pady_);
+            outW_ = (int)std::round(Ws * scale_);
+            outH_ = (int)std::round(Hs * scale_);
+            sx = sy = scale_;
+        } else {
+            scale_ = 1.f; padx_ = pady_ = 0;
+            outW_ = Wd; outH_ = Hd;
+            sx = (float)Wd / (float)Ws;
+            sy = (float)Hd / (float)Hs;
+        }
+        buildAxis_(x_, outW_, Ws, sx);
+        buildAxis_(y_, outH_, Hs, sy);
+        row_.resize(Ws);
+        rows_.resize(y_.K);
+        wy_.resize(y_.K);
+        return true;
+    }
+
+    int outW()  const { return outW_; }   ///< width of the resampled region
+    int outH()  const { return outH_; }
+    int padX()  const { return padx_; }   ///< region offset in the destination
+    int padY()  const { return pady_; }
+    float scale() const { return scale_; } ///< letterbox scale (1 when stretched)
+    ResampleMode mode() const { return mode_; }
+
+    /// Output row j (0..outH) of one source plane into dst[0..outW).
+    void row(const float* src, int j, float* dst) const {
+        const float* srow;
+        int k = 0;
+        for (int t = 0; t < y_.K; ++t) {
+            const size_t at = (size_t)t * outH_ + j;
+            if (y_.w[at] == 0.f) continue;
+            rows_[k] = src + (size_t)y_.idx[at] * Ws_;
+            wy_[k++] = y_.w[at];
+        }
+        if (k == 1 && wy_[0] == 1.f) {
+            srow = rows_[0];
+        } else {
+            simd::weightedSum(rows_.data(), wy_.data(), k, (size_t)Ws_, row_.data());
+            srow = row_.data();
+        }
+        simd::gatherWeighted(srow, x_.idx.data(), x_.w.data(), x_.K, (size_t)outW_, dst);
+    }
+
+    /// Resample C planes (src planes Ws*Hs apart, dst planes Wd*Hd apart).
+    /// Only the outW x outH region at (padX, padY) is written; letterbox
+    /// padding is left to the caller (zero-filled buffers).
+    void run(const float* src, float* dst, int C) const {
+        const size_t splane = (size_t)Ws_ * Hs_, dplane = (size_t)Wd_ * Hd_;
+        for (int c = 0; c < C; ++c)
+            for (int j = 0; j < outH_; ++j)
+                row(src + c * splane, j, dst + c * dplane + (size_t)(j + pady_) * Wd_ + padx_);
+    }
 
-    for (int y = 0; y < newH; ++y) {
-        int sy = std::min(Hs - 1, (int)std::floor(y / scale));
-        for (int x = 0; x < newW; ++x) {
-            int sx = std::min(Ws - 1, (int)std::floor(x / scale));
-            for (int c = 0; c < C; ++c) {
-                dst[(size_t)c * Hd * Wd + (size_t)(y + pady) * Wd + (x + padx)] =
-                    src[(size_t)c * Hs * Ws + (size_t)sy * Ws + sx];
+private:
+    struct Axis {
+        int K = 1;                 ///< taps per output sample
+        std::vector<int32_t> idx;  ///< [K * n] source indices, tap-major
+        std::vector<float>   w;    ///< [K * n] weights (sum to 1 per sample)
+    };
+
+    void buildAxis_(Axis& a, int n, int src_n, float scale) const {
+        std::vector<std::vector<std::pair<int, float>>> taps(n);
+        for (int o = 0; o < n; ++o) {
+            auto& t = taps[o];
+            if (mode_ == ResampleMode::Nearest) {
+                t.push_back({std::min(src_n - 1, (int)std::floor(o / scale)), 1.f});
+            } else if (mode_ == ResampleMode::Bilinear) {
+                float f = std::max(0.f, (o + 0.5f) / scale - 0.5f);
+                int i0 = std::min(src_n - 1, (int)f);
+                int i1 = std::min(src_n - 1, i0 + 1);
+                float a1 = i1 == i0 ? 0.f : std::min(1.f, f - i0);
+                t.push_back({i0, 1.f - a1});
+                if (i1 != i0 && a1 > 0.f) t.push_back({i1, a1});
+            } else {
+                // Source interval [o/scale, (o+1)/scale), weighted by overlap
+                const float lo = o / scale, hi = std::min((float)src_n, (o + 1) / scale);
+                float sum = 0.f;
+                for (int i = (int)std::floor(lo); i < hi && i < src_n; ++i) {
+                    float ov = std::min(hi, (float)(i + 1)) - std::max(lo, (float)i);
+                    if (ov > 1e-6f) { t.push_back({i, ov}); sum += ov; }
+                }
+                if (t.empty()) { t.push_back({std::min(src_n - 1, (int)lo), 1.f}); sum = 1.f; }
+                for (auto& p : t) p.second /= sum;
             }
         }
+        a.K = 1;
+        for (const auto& t : taps) a.K = std::max(a.K, (int)t.size());
+        a.idx.assign((size_t)n * a.K, 0);
+        a.w.assign((size_t)n * a.K, 0.f);
+        for (int o = 0; o < n; ++o)
+            for (int k = 0; k < a.K; ++k) {
+                // Unused taps repeat the first index with weight 0
+                const bool used = k < (int)taps[o].size();
+                a.idx[(size_t)k * n + o] = taps[o][used ? k : 0].first;
+                a.w[(size_t)k * n + o]   = used ? taps[o][k].second : 0.f;
+            }
     }
+
+    int Ws_ = 0, Hs_ = 0, Wd_ = 0, Hd_ = 0;
+    ResampleMode mode_ = ResampleMode::Nearest;
+    bool letterbox_ = true;
+    float scale_ = 1.f;
+    int padx_ = 0, pady_ = 0, outW_ = 0, outH_ = 0;
+    Axis x_, y_;
+    mutable std::vector<float> row_;           ///< vertically combined source row
+    mutable std::vector<const float*> rows_;   ///< source rows of the current output row
+    mutable std::vector<float> wy_;
+};
+
+/// Nearest-neighbour letterbox for CHW float buffers.
+/// Resizes (C, Hs, Ws) -> (C, Hd, Wd) preserving aspect ratio,
+/// padding with zeros.  Returns the resulting buffer and writes
+/// back the computed `scale`, `padx`, `pady`.
+/// Builds a ResamplePlan per call; keep a plan to resample every frame.
+inline std::vector<float> letterboxCHW(
+    const std::vector<float>& src,
+    int C, int Hs, int Ws,
+    int Hd, int Wd,
+    float& scale, int& padx, int& pady)
+{
+    std::vector<float> dst((size_t)C * Hd * Wd, 0.0f);
+    ResamplePlan plan;
+    plan.ensure(Ws, Hs, Wd, Hd, ResampleMode::Nearest);
+    plan.run(src.data(), dst.data(), C);
+    scale = plan.scale(); padx = plan.padX(); pady = plan.padY();
     return dst;
 }
 
 /// Letterbox into a pre-allocated destination buffer (avoids allocation).
 /// `dst` must already be sized to C * Hd * Wd and zero-filled by the caller.
+/// `scale`, `padx` and `pady` must come from letterboxParams().
 inline void letterboxCHW_into(
     const float* src, int C, int Hs, int Ws,
     float* dst, int Hd, int Wd,
-    float scale, int padx, int pady)
-{
-    for (int y = 0; y < (int)std::round(Hs * scale); ++y) {
-        int sy = std::min(Hs - 1, (int)std::floor(y / scale));
-        for (int x = 0; x < (int)std::round(Ws * scale); ++x) {
-            int sx = std::min(Ws - 1, (int)std::floor(x / scale));
-            for (int c = 0; c < C; ++c) {
-                dst[(size_t)c * Hd * Wd + (size_t)(y + pady) * Wd + (x + padx)] =
-                    src[(size_t)c * Hs * Ws + (size_t)sy * Ws + sx];
-            }
-        }
-    }
-}
-
-/// Compute letterbox scale and padding without actually transforming data.
-inline void letterboxParams(
-    int Ws, int Hs, int Wd, int Hd,
-    float& scale, int& padx, int& pady)
+    float /*scale*/, int /*padx*/, int /*pady*/)
 {
-    scale = std::min((float)Wd / (float)Ws, (float)Hd / (float)Hs);
-    const int newW = (int)std::round(Ws * scale);
-    const int newH = (int)std::round(Hs * scale);
-    padx = (Wd - newW) / 2;
-    pady = (Hd - newH) / 2;
+    ResamplePlan plan;
+    plan.ensure(Ws, Hs, Wd, Hd, ResampleMode::Nearest);
+    plan.run(src, dst, C);
 }
 
 /// Unletterbox coordinates from model space back to sensor space.
@@ -159,4 +401,51 @@ inline float rectIoU(const ofRectangle& A, const ofRectangle& B) {
     return denom > 0.f ? inter / denom : 0.f;
 }
 
+// ---------------------------------------------------------------------------
+// Tensor buffer pool
+// ---------------------------------------------------------------------------
+
+/// Fixed-size tensor buffers recycled between the main thread and an
+/// inference worker.  acquire() hands out a buffer nobody else references;
+/// passing the shared_ptr into a job and dropping it when the job ends
+/// returns the buffer to the pool, so steady-state inference allocates no
+/// tensor memory.  acquire()/reset() must be called from one thread.
+template <typename T>
+class BasicTensorPool {
+public:
+    using Ptr = std::shared_ptr<std::vector<T>>;
+
+    /// Set the buffer size.  Drops pooled buffers if the size changes
+    /// (buffers still held elsewhere are freed when released).
+    void reset(size_t n) {
+        if (n == n_) return;
+        n_ = n;
+        slots_.clear();
+    }
+
+    /// Get a zero-initialised-on-creation buffer of size() elements that is
+    /// not referenced by any job.  Reused buffers keep their old contents.
+    Ptr acquire() {
+        for (auto& s : slots_) {
+            if (s.use_count() == 1) {
+                // pair with the releasing thread's decrement before reuse
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return s;
+            }
+        }
+        slots_.push_back(std::make_shared<std::vector<T>>(n_, T(0)));
+        return slots_.back();
+    }
+
+    size_t size() const { return n_; }
+    size_t numBuffers() const { return slots_.size(); }
+
+private:
+    size_t n_ = 0;
+    std::vector<Ptr> slots_;
+};
+
+using TensorPool     = BasicTensorPool<float>;
+using HalfTensorPool = BasicTensorPool<uint16_t>;   ///< IEEE binary16 bits
+
 }} // namespace dvs::nn
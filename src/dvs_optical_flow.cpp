@@ -0,0 +1,459 @@
+#include "dvs_optical_flow.hpp"
+#include "ofxDVS.hpp" // for struct polarity
+#include "dvs_simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <memory>
+#include <thread>
+
+namespace dvs {
+
+// ---- allocate ----
+void OpticalFlow::allocate(int W, int H) {
+    if (W == W_ && H == H_ && image_.isAllocated()) return;
+    W_ = W;
+    H_ = H;
+    sae_.assign((size_t)W * H, 0);
+    fx_.assign((size_t)W * H, 0.0f);
+    fy_.assign((size_t)W * H, 0.0f);
+    image_.allocate(W, H, OF_IMAGE_COLOR);
+    image_.getPixels().set(0);
+}
+
+// ---- clear ----
+void OpticalFlow::clear() {
+    std::fill(sae_.begin(), sae_.end(), 0);
+    std::fill(fx_.begin(), fx_.end(), 0.0f);
+    std::fill(fy_.begin(), fy_.end(), 0.0f);
+}
+
+// ---- updateSAE ----
+void OpticalFlow::updateSAE(const std::vector<polarity>& events) {
+    for (const auto& e : events) {
+        if (!e.valid) continue;
+        int ex = (int)e.pos.x, ey = (int)e.pos.y;
+        if (ex >= 0 && ex < W_ && ey >= 0 && ey < H_)
+            sae_[ey * W_ + ex] = e.timestamp;
+    }
+}
+
+// ---- fitPlane_ ----
+bool OpticalFlow::fitPlane_(int ex, int ey, int64_t t0, int R, int64_t dt_thresh,
+                            float max_speed, float& vx, float& vy) const {
+    // Accumulate normal equations for t = a*dx + b*dy + c
+    // Using Cramer's rule on the 3x3 system:
+    //   [sum(dx^2)  sum(dx*dy) sum(dx) ] [a]   [sum(dx*t)]
+    //   [sum(dx*dy) sum(dy^2)  sum(dy) ] [b] = [sum(dy*t)]
+    //   [sum(dx)    sum(dy)    N       ] [c]   [sum(t)   ]
+    double Sxx = 0, Syy = 0, Sxy = 0, Sx = 0, Sy = 0;
+    double Sxt = 0, Syt = 0, St = 0;
+    int N = 0;
+
+    for (int dy = -R; dy <= R; dy++) {
+        const int64_t* row = &sae_[(ey + dy) * W_ + ex];
+        for (int dx = -R; dx <= R; dx++) {
+            int64_t ts = row[dx];
+            if (ts == 0) continue;
+            int64_t age = t0 - ts;
+            if (age < 0 || age > dt_thresh) continue;
+            double dt = (double)(ts - t0); // relative timestamp (negative or zero)
+            Sxx += dx * dx;
+            Syy += dy * dy;
+            Sxy += dx * dy;
+            Sx  += dx;
+            Sy  += dy;
+            Sxt += dx * dt;
+            Syt += dy * dt;
+            St  += dt;
+            N++;
+        }
+    }
+
+    return solvePlane_(Sxx, Syy, Sxy, Sx, Sy, Sxt, Syt, St, N, max_speed, vx, vy);
+}
+
+// ---- solvePlane_ ----
+bool OpticalFlow::solvePlane_(double Sxx, double Syy, double Sxy, double Sx, double Sy,
+                              double Sxt, double Syt, double St, double N,
+                              float max_speed, float& vx, float& vy) {
+    if (N < 5.5) return false; // need enough neighbors for robust fit
+
+    // Solve 3x3 system via Cramer's rule
+    // M = [[Sxx, Sxy, Sx], [Sxy, Syy, Sy], [Sx, Sy, N]]
+    double det = Sxx * (Syy * N - Sy * Sy)
+               - Sxy * (Sxy * N - Sy * Sx)
+               + Sx  * (Sxy * Sy - Syy * Sx);
+
+    if (std::abs(det) < 1e-6) return false; // near-singular
+
+    double detA = Sxt * (Syy * N - Sy * Sy)
+                - Sxy * (Syt * N - Sy * St)
+                + Sx  * (Syt * Sy - Syy * St);
+
+    double detB = Sxx * (Syt * N - Sy * St)
+                - Sxt * (Sxy * N - Sy * Sx)
+                + Sx  * (Sxy * St - Syt * Sx);
+
+    double a = detA / det; // dt/dx in microseconds/pixel
+    double b = detB / det; // dt/dy in microseconds/pixel
+
+    // Use the gradient vector directly: v = -(a,b) / (a^2+b^2) * 1e6  (px/s)
+    double denom = a * a + b * b;
+    if (denom < 1e-20) return false;
+    vx = (float)(-a / denom * 1e6);
+    vy = (float)(-b / denom * 1e6);
+
+    float mag = std::sqrt(vx * vx + vy * vy);
+    return mag <= max_speed * 5.0f; // reject outliers
+}
+
+// ---- buildIntegral_ ----
+void OpticalFlow::buildIntegral_(int64_t t_ref, int64_t dt_thresh,
+                                 int x0, int y0, int w, int h, ThreadPool* pool) {
+    sat_x0_ = x0;
+    sat_y0_ = y0;
+    sat_w_  = w;
+    sat_h_  = h;
+    const int W1 = w + 1;
+    sat_.resize((size_t)W1 * (h + 1));
+    std::fill(sat_.begin(), sat_.begin() + W1, Moments{});
+
+    // 1) per-row prefix sums of the moments of valid pixels
+    auto rows = [&](size_t r0, size_t r1) {
+        for (size_t ly = r0; ly < r1; ++ly) {
+            Moments r;
+            Moments* out = &sat_[(ly + 1) * W1];
+            out[0] = Moments{};
+            const size_t y = y0 + ly;
+            const int64_t* row = &sae_[y * W_ + x0];
+            const double dy = (double)y;
+            for (int lx = 0; lx < w; ++lx) {
+                const int64_t ts = row[lx];
+                const int64_t age = t_ref - ts;
+                if (ts != 0 && age >= 0 && age <= dt_thresh) {
+                    const double dx = (double)(x0 + lx), t = (double)(ts - t_ref);
+                    r.m  += 1;       r.x  += dx;      r.y  += dy;
+                    r.xx += dx * dx; r.yy += dy * dy; r.xy += dx * dy;
+                    r.t  += t;       r.xt += dx * t;  r.yt += dy * t;
+                }
+                out[lx + 1] = r;
+            }
+        }
+    };
+    // 2) accumulate rows downwards, columns split across threads
+    auto cols = [&](size_t x0, size_t x1) {
+        for (int y = 1; y <= h; ++y) {
+            const Moments* up = &sat_[(size_t)(y - 1) * W1];
+            Moments* cur = &sat_[(size_t)y * W1];
+            for (size_t x = x0; x < x1; ++x) {
+                Moments& c = cur[x];
+                const Moments& u = up[x];
+                c.m  += u.m;  c.x  += u.x;  c.y  += u.y;
+                c.xx += u.xx; c.yy += u.yy; c.xy += u.xy;
+                c.t  += u.t;  c.xt += u.xt; c.yt += u.yt;
+            }
+        }
+    };
+    if (pool) {
+        pool->parallelFor(h, 16, rows);
+        pool->parallelFor(W1, 32, cols);
+    } else {
+        rows(0, h);
+        cols(0, W1);
+    }
+}
+
+// ---- fitIntegral_ ----
+bool OpticalFlow::fitIntegral_(int ex, int ey, int R, float max_speed,
+                               float& vx, float& vy) const {
+    // Table-local corners of the window (the table covers every window)
+    const int W1 = sat_w_ + 1;
+    const int lx = ex - sat_x0_, ly = ey - sat_y0_;
+    const Moments& A = sat_[(size_t)(ly + R + 1) * W1 + (lx + R + 1)];
+    const Moments& B = sat_[(size_t)(ly - R)     * W1 + (lx + R + 1)];
+    const Moments& C = sat_[(size_t)(ly + R + 1) * W1 + (lx - R)];
+    const Moments& D = sat_[(size_t)(ly - R)     * W1 + (lx - R)];
+    auto box = [&](double Moments::*f) { return A.*f - B.*f - C.*f + D.*f; };
+
+    const double N = box(&Moments::m);
+    if (N < 5.5) return false;
+    const double X = box(&Moments::x), Y = box(&Moments::y);
+    const double XX = box(&Moments::xx), YY = box(&Moments::yy), XY = box(&Moments::xy);
+    const double T = box(&Moments::t), XT = box(&Moments::xt), YT = box(&Moments::yt);
+
+    // Re-centre the absolute moments on the event pixel
+    const double cx = ex, cy = ey;
+    const double Sx  = X - cx * N;
+    const double Sy  = Y - cy * N;
+    const double Sxx = XX - 2.0 * cx * X + cx * cx * N;
+    const double Syy = YY - 2.0 * cy * Y + cy * cy * N;
+    const double Sxy = XY - cx * Y - cy * X + cx * cy * N;
+    const double Sxt = XT - cx * T;
+    const double Syt = YT - cy * T;
+    return solvePlane_(Sxx, Syy, Sxy, Sx, Sy, Sxt, Syt, T, N, max_speed, vx, vy);
+}
+
+// ---- computeFlow ----
+void OpticalFlow::computeFlow(const std::vector<polarity>& events, int radius, int dt_us,
+                              float max_speed, int stride, ThreadPool* pool,
+                              FlowMethod method) {
+    const int R = radius;
+    const int64_t dt_thresh = (int64_t)dt_us;
+    stride = std::max(1, stride);
+
+    // Select events (valid, inside the fit border, every stride-th) and
+    // their bounding box
+    selected_.clear();
+    int64_t t_ref = 0;
+    int k = 0;
+    int bx0 = W_, by0 = H_, bx1 = -1, by1 = -1;
+    for (size_t i = 0; i < events.size(); ++i) {
+        const auto& e = events[i];
+        if (!e.valid) continue;
+        t_ref = std::max<int64_t>(t_ref, e.timestamp);
+        if ((k++ % stride) != 0) continue;
+        int ex = (int)e.pos.x, ey = (int)e.pos.y;
+        if (ex < R || ex >= W_ - R || ey < R || ey >= H_ - R) continue;
+        selected_.push_back((int)i);
+        bx0 = std::min(bx0, ex); bx1 = std::max(bx1, ex);
+        by0 = std::min(by0, ey); by1 = std::max(by1, ey);
+    }
+    samples_.resize(selected_.size());
+    used_integral_ = false;
+    if (selected_.empty()) return;
+
+    // Tables only over the events' windows, and only when building them is
+    // cheaper than scanning those windows per event (a sparse packet spread
+    // over the sensor keeps the direct fit)
+    bool integral = (method == FlowMethod::Integral);
+    if (integral) {
+        const int w = bx1 - bx0 + 2 * R + 1, h = by1 - by0 + 2 * R + 1;
+        const size_t win = (size_t)(2 * R + 1) * (2 * R + 1);
+        integral = (size_t)w * h * kTableCellCost < selected_.size() * win;
+        if (integral) buildIntegral_(t_ref, dt_thresh, bx0 - R, by0 - R, w, h, pool);
+    }
+    used_integral_ = integral;
+
+    // Parallel fits: SAE / tables are read-only here, each event owns its slot
+    auto fitRange = [&](size_t b, size_t e) {
+        for (size_t s = b; s < e; ++s) {
+            const auto& ev = events[selected_[s]];
+            int ex = (int)ev.pos.x, ey = (int)ev.pos.y;
+            FlowSample& out = samples_[s];
+            bool ok = integral
+                ? fitIntegral_(ex, ey, R, max_speed, out.vx, out.vy)
+                : fitPlane_(ex, ey, ev.timestamp, R, dt_thresh, max_speed, out.vx, out.vy);
+            out.idx = ok ? ey * W_ + ex : -1;
+        }
+    };
+    if (pool) pool->parallelFor(selected_.size(), 256, fitRange);
+    else      fitRange(0, selected_.size());
+
+    // Serial scatter in event order (later events win, as before)
+    for (const auto& s : samples_) {
+        if (s.idx < 0) continue;
+        fx_[s.idx] = s.vx;
+        fy_[s.idx] = s.vy;
+    }
+}
+
+// ---- renderAndDecay ----
+void OpticalFlow::renderAndDecay(float decay, float max_speed, ThreadPool* pool) {
+    unsigned char* raw = image_.getPixels().getData();
+    const float inv_max = 1.0f / std::max(1e-3f, max_speed);
+
+    // Branchless colour kernel (AVX2 / NEON / scalar) over row bands
+    auto rows = [&](size_t y0, size_t y1) {
+        const size_t i0 = y0 * W_;
+        simd::flowColor(&fx_[i0], &fy_[i0], (y1 - y0) * W_, decay, inv_max, raw + i0 * 3);
+    };
+    if (pool) pool->parallelFor(H_, 16, rows);
+    else      rows(0, H_);
+
+    image_.update();
+}
+
+// ---- benchmark ----
+// Synthetic scene on a W x H sensor: one vertical edge sweeping right from
+// the left border or, with two_edges, a second one sweeping left from the
+// right border, at 400 px/s with timing jitter.  90 ms of history fill the
+// SAE, the last 10 ms form the packet.
+static void flowScene(int W, int H, bool two_edges, float speed,
+                      std::vector<polarity>& history, std::vector<polarity>& packet) {
+    std::mt19937 rng(42);
+    std::normal_distribution<float> jitter(0.0f, 150.0f);
+    for (int64_t t = 1000; t < 101000; t += 50) {
+        const int d = (int)(speed * (t - 1000) * 1e-6f);
+        for (int edge = 0; edge < (two_edges ? 2 : 1); ++edge) {
+            const int x = edge == 0 ? 20 + d : W - 21 - d;
+            for (int y = 10; y < H - 10; y += 2) {
+                polarity p;
+                p.pos.x = x;
+                p.pos.y = y + (int)(rng() & 1);
+                p.timestamp = t + (int64_t)jitter(rng);
+                p.pol = true;
+                p.valid = true;
+                (t < 91000 ? history : packet).push_back(p);
+            }
+        }
+    }
+}
+
+void OpticalFlow::benchmark(ThreadPool* pool) {
+    const float speed = 400.0f;
+    const int64_t dt_thresh = 50000;
+    using clk = std::chrono::steady_clock;
+    auto us = [](clk::time_point a, clk::time_point b) {
+        return std::chrono::duration<double, std::micro>(b - a).count();
+    };
+
+    for (const auto& size : {std::make_pair(346, 260), std::make_pair(640, 480)}) {
+        const int W = size.first, H = size.second;
+        for (bool two_edges : {false, true}) {
+            std::vector<polarity> history, full;
+            flowScene(W, H, two_edges, speed, history, full);
+
+            for (size_t n_ev : {(size_t)300, (size_t)2000, full.size()}) {
+                // The newest n_ev events of the 10 ms packet
+                const std::vector<polarity> packet(full.end() - std::min(n_ev, full.size()), full.end());
+                int64_t t_ref = 0;
+                for (const auto& e : packet) t_ref = std::max<int64_t>(t_ref, e.timestamp);
+
+                for (int R : {3, 7}) {
+                    OpticalFlow ref, fast;
+                    ref.allocate(W, H);
+                    fast.allocate(W, H);
+                    ref.updateSAE(history);  ref.updateSAE(full);
+                    fast.updateSAE(history); fast.updateSAE(full);
+
+                    double best_ref = 1e30, best_fast = 1e30, best_build = 0.0;
+                    for (int rep = 0; rep < 5; ++rep) {
+                        auto t0 = clk::now();
+                        ref.computeFlow(packet, R, (int)dt_thresh, 1000.0f, 1, pool, FlowMethod::PlaneFit);
+                        auto t1 = clk::now();
+                        fast.computeFlow(packet, R, (int)dt_thresh, 1000.0f, 1, pool, FlowMethod::Integral);
+                        auto t2 = clk::now();
+                        best_ref  = std::min(best_ref,  us(t0, t1));
+                        best_fast = std::min(best_fast, us(t1, t2));
+                    }
+                    // Per-packet fixed cost: the table build alone
+                    if (fast.used_integral_) {
+                        best_build = 1e30;
+                        for (int rep = 0; rep < 5; ++rep) {
+                            auto t0 = clk::now();
+                            fast.buildIntegral_(t_ref, dt_thresh, fast.sat_x0_, fast.sat_y0_,
+                                                fast.sat_w_, fast.sat_h_, pool);
+                            best_build = std::min(best_build, us(t0, clk::now()));
+                        }
+                    }
+
+                    // Agreement over events fitted by both methods
+                    int both = 0;
+                    double err = 0.0, mean_speed = 0.0;
+                    for (size_t i = 0; i < ref.samples_.size(); ++i) {
+                        const auto& a = ref.samples_[i];
+                        const auto& b = fast.samples_[i];
+                        if (a.idx < 0 || b.idx < 0) continue;
+                        ++both;
+                        err += std::hypot(a.vx - b.vx, a.vy - b.vy) / std::max(1.0f, std::hypot(a.vx, a.vy));
+                        mean_speed += std::hypot(b.vx, b.vy);
+                    }
+                    const double n = (double)std::max<size_t>(1, packet.size());
+                    std::ostringstream detail;
+                    if (fast.used_integral_)
+                        detail << "tables " << fast.sat_w_ << "x" << fast.sat_h_ << " "
+                               << best_build / 1000.0 << " ms + "
+                               << (best_fast - best_build) * 1000.0 / n << " ns/ev";
+                    else
+                        detail << "direct fit";
+                    ofLogNotice() << "[FlowBench] " << W << "x" << H << (two_edges ? " spread" : " compact")
+                                  << " R=" << R << " events=" << packet.size()
+                                  << " planefit=" << best_ref / 1000.0 << " ms ("
+                                  << best_ref * 1000.0 / n << " ns/ev)"
+                                  << " integral=" << best_fast / 1000.0 << " ms (" << detail.str() << ")"
+                                  << " speedup=" << best_ref / std::max(1e-3, best_fast) << "x"
+                                  << " agree=" << both
+                                  << " rel_err=" << (both ? err / both : 0.0)
+                                  << " speed=" << (both ? mean_speed / both : 0.0) << " px/s (true " << speed << ")";
+                }
+            }
+        }
+    }
+
+    // Colour pass, scalar vs the dispatched kernel, one thread
+    for (const auto& size : {std::make_pair(346, 260), std::make_pair(640, 480)}) {
+        const int W = size.first, H = size.second;
+        const size_t n = (size_t)W * H;
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> v(-1200.0f, 1200.0f);
+        std::vector<float> vx0(n), vy0(n);
+        for (size_t i = 0; i < n; ++i) {
+            // A third of the pixels at rest, as in a sparse flow map
+            const bool moving = (rng() % 3) != 0;
+            vx0[i] = moving ? v(rng) : 0.0f;
+            vy0[i] = moving ? v(rng) : 0.0f;
+        }
+        std::vector<uint8_t> rgb_s(n * 3), rgb_v(n * 3);
+        std::vector<float> vx, vy;
+        auto run = [&](std::vector<uint8_t>& rgb) {
+            double best = 1e30;
+            for (int rep = 0; rep < 20; ++rep) {
+                vx = vx0;
+                vy = vy0;
+                auto t0 = clk::now();
+                simd::flowColor(vx.data(), vy.data(), n, 0.9f, 1.0f / 1000.0f, rgb.data());
+                best = std::min(best, us(t0, clk::now()));
+            }
+            return best;
+        };
+        const bool wasForced = simd::activeIsa() == simd::Isa::Scalar;
+        simd::forceScalar(true);
+        const double t_s = run(rgb_s);
+        simd::forceScalar(wasForced);
+        const double t_v = run(rgb_v);
+        int max_d = 0;
+        for (size_t i = 0; i < n * 3; ++i) max_d = std::max(max_d, std::abs(rgb_s[i] - rgb_v[i]));
+        ofLogNotice() << "[FlowBench] colour " << W << "x" << H
+                      << " scalar=" << t_s / 1000.0 << " ms "
+                      << simd::isaName(simd::activeIsa()) << "=" << t_v / 1000.0 << " ms"
+                      << " speedup=" << t_s / std::max(1e-3, t_v) << "x max|d|=" << max_d;
+    }
+
+    // Thread scaling of the per-event fits: full spread packet at 640x480
+    {
+        std::vector<polarity> history, packet;
+        flowScene(640, 480, true, speed, history, packet);
+        const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<unsigned> counts = {1, 2, 4};
+        if (hw > 4) counts.push_back(hw);
+        for (FlowMethod method : {FlowMethod::PlaneFit, FlowMethod::Integral}) {
+            double t1 = 0.0;
+            for (unsigned threads : counts) {
+                std::unique_ptr<ThreadPool> tp;
+                if (threads > 1) tp = std::make_unique<ThreadPool>(threads - 1);
+                OpticalFlow f;
+                f.allocate(640, 480);
+                f.updateSAE(history);
+                f.updateSAE(packet);
+                double best = 1e30;
+                for (int rep = 0; rep < 5; ++rep) {
+                    auto t0 = clk::now();
+                    f.computeFlow(packet, 5, (int)dt_thresh, 1000.0f, 1, tp.get(), method);
+                    best = std::min(best, us(t0, clk::now()));
+                }
+                if (threads == 1) t1 = best;
+                ofLogNotice() << "[FlowBench] threads=" << threads << " (" << hw << " hw)"
+                              << (method == FlowMethod::PlaneFit ? " planefit" : " integral")
+                              << " R=5 events=" << packet.size()
+                              << " " << best / 1000.0 << " ms"
+                              << " scaling=" << t1 / std::max(1e-3, best) << "x";
+            }
+        }
+    }
+}
+
+} // namespace dvs
@@ -0,0 +1,409 @@
+#include "dvs_roi_pipeline.hpp"
+#include "ofxDVS.hpp" // for struct polarity
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace dvs {
+
+// ---- loadModel ----
+OnnxRunner::Config RoiPipeline::runnerConfig_(const std::string& path, int threads) {
+    OnnxRunner::Config rcfg;
+    rcfg.model_path = path;
+    rcfg.thread_budget = threads;
+    rcfg.normalize_01 = false;  // crops are built in [0,1]
+    rcfg.verbose = false;
+    return rcfg;
+}
+
+void RoiPipeline::loadModel(const std::string& path, int threads) {
+    auto runner = std::make_unique<OnnxRunner>(runnerConfig_(path, threads));
+    runner->load();
+    std::lock_guard<std::mutex> lk(run_mu_);
+    install_(std::move(runner));
+}
+
+bool RoiPipeline::loadModelAsync(const std::string& path, int threads) {
+    if (pending_ || !loader_.start(runnerConfig_(path, threads))) {
+        ofLogWarning() << "[RoiPipeline] a model load is already in progress";
+        return false;
+    }
+    ofLogNotice() << "[RoiPipeline] loading " << path << " in the background";
+    return true;
+}
+
+bool RoiPipeline::pollLoad() {
+    if (!pending_) {
+        if (!loader_.busy()) return false;
+        pending_ = loader_.take();
+        if (!pending_) {
+            if (!loader_.busy())
+                ofLogError() << "[RoiPipeline] failed to load " << loader_.path()
+                             << ": " << loader_.error();
+            return false;
+        }
+        swap_pending_ = true;
+    }
+    std::unique_lock<std::mutex> lk(run_mu_, std::try_to_lock);
+    if (!lk.owns_lock()) return false;
+    install_(std::move(pending_));
+    swap_pending_ = false;
+    return true;
+}
+
+LoadState RoiPipeline::loadState() const {
+    if (loader_.busy() || pending_) return LoadState::Loading;
+    if (isLoaded()) return LoadState::Ready;
+    return loader_.error().empty() ? LoadState::Empty : LoadState::Failed;
+}
+
+void RoiPipeline::install_(std::unique_ptr<OnnxRunner> runner) {
+    nn_ = std::move(runner);
+    model_path_ = nn_->config().model_path;
+
+    // Input [N, C, H, W]; dynamic dims fall back to a 3 x 64 x 64 crop
+    const auto& in = nn_->inputs().front().dims;
+    auto dim = [&](size_t i, int def) { return i < in.size() && in[i] > 0 ? (int)in[i] : def; };
+    model_C_ = dim(1, 3);
+    model_H_ = dim(2, 64);
+    model_W_ = dim(3, 64);
+    half_input_ = nn_->inputIsF16(0);
+    if (nn_->inputs().size() != 1)
+        ofLogWarning() << "[RoiPipeline] model has " << nn_->inputs().size()
+                       << " inputs; crop batches need a single-input model";
+
+    out_idx_ = std::max(0, nn_->outputIndex("output0"));
+    const auto& od = nn_->outputs()[out_idx_].dims;
+    out_rank_ = (int)od.size();
+    out_C_ = out_rank_ == 3 && od[1] > 0 ? (int)od[1] : 0;
+
+    dets_.clear();
+
+    ofLogNotice() << "[RoiPipeline] loaded " << nn_->loadedPath()
+                  << " crop=" << model_C_ << "x" << model_W_ << "x" << model_H_
+                  << (out_rank_ == 3 ? " detector" : " classifier")
+                  << (nn_->supportsBatch() ? " batched" : " batch=1")
+                  << (half_input_ ? " input=float16" : " input=float32");
+}
+
+// ---- selectCrops_ ----
+void RoiPipeline::selectCrops_(const std::vector<ofRectangle>& clusters, int sW, int sH,
+                               std::vector<RoiCrop>& crops) const
+{
+    crops.clear();
+    const ofRectangle sensor(0, 0, sW, sH);
+
+    std::vector<ofRectangle> targets;
+    if (cfg.merge) {
+        // Grow each cluster by the margin, then merge grown bounds that
+        // overlap until none do; the crop is the grown union
+        std::vector<ofRectangle> grown;
+        for (const auto& b : clusters) {
+            const float mx = cfg.merge_margin * b.getWidth(), my = cfg.merge_margin * b.getHeight();
+            grown.emplace_back(b.x - mx, b.y - my, b.getWidth() + 2.f * mx, b.getHeight() + 2.f * my);
+            targets.push_back(b);
+        }
+        for (bool merged = true; merged;) {
+            merged = false;
+            for (size_t i = 0; i < grown.size() && !merged; ++i)
+                for (size_t j = i + 1; j < grown.size(); ++j) {
+                    if (!grown[i].intersects(grown[j])) continue;
+                    grown[i].growToInclude(grown[j]);
+                    targets[i].growToInclude(targets[j]);
+                    grown.erase(grown.begin() + j);
+                    targets.erase(targets.begin() + j);
+                    merged = true;
+                    break;
+                }
+        }
+        for (size_t i = 0; i < grown.size(); ++i) {
+            const ofRectangle g = grown[i].getIntersection(sensor);
+            const int x0 = (int)std::floor(g.x), y0 = (int)std::floor(g.y);
+            const int x1 = (int)std::ceil(g.getRight()), y1 = (int)std::ceil(g.getBottom());
+            if (x1 <= x0 || y1 <= y0) continue;
+            RoiCrop c;
+            c.region.set(x0, y0, x1 - x0, y1 - y0);
+            c.target = targets[i].getIntersection(sensor);
+            crops.push_back(c);
+        }
+    } else {
+        // Fixed square centred on the cluster, shifted to stay on the sensor
+        const int s = std::max(1, std::min({cfg.crop_px, sW, sH}));
+        for (const auto& b : clusters) {
+            const ofPoint ctr = b.getCenter();
+            const int x0 = std::min(sW - s, std::max(0, (int)std::lround(ctr.x - 0.5f * s)));
+            const int y0 = std::min(sH - s, std::max(0, (int)std::lround(ctr.y - 0.5f * s)));
+            RoiCrop c;
+            c.region.set(x0, y0, s, s);
+            c.target = b.getIntersection(c.region);
+            crops.push_back(c);
+        }
+    }
+
+    std::sort(crops.begin(), crops.end(), [](const RoiCrop& a, const RoiCrop& b) {
+        return a.target.getArea() > b.target.getArea();
+    });
+    if ((int)crops.size() > std::max(0, cfg.max_crops)) crops.resize(std::max(0, cfg.max_crops));
+}
+
+// ---- prepare ----
+bool RoiPipeline::prepare(const std::vector<ofRectangle>& clusters,
+                          const std::vector<polarity>& events,
+                          const float* surfaceMapLastTs,
+                          int sW, int sH, RoiInput& out)
+{
+    out.crops.clear();
+    last_crops_ = 0;
+    last_frac_ = 0.f;
+    if (!isLoaded() || swap_pending_ || clusters.empty() || sW <= 0 || sH <= 0) return false;
+
+    selectCrops_(clusters, sW, sH, out.crops);
+    const size_t n = out.crops.size();
+    if (n == 0) return false;
+
+    // Per-crop pos / neg / T planes, crop pixels only
+    size_t total = 0;
+    float area = 0.f;
+    plane_off_.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        plane_off_[k] = total;
+        total += (size_t)3 * (size_t)out.crops[k].region.getArea();
+        area += out.crops[k].region.getArea();
+    }
+    planes_.assign(total, 0.f);
+
+    long latest_ts = 0;
+    for (const auto& e : events)
+        if (e.valid && e.timestamp > latest_ts) latest_ts = e.timestamp;
+    const long win_us = (long)(cfg.win_ms * 1000.f);
+    for (const auto& e : events) {
+        if (!e.valid || e.timestamp + win_us < latest_ts) continue;
+        const int x = (int)e.pos.x, y = (int)e.pos.y;
+        for (size_t k = 0; k < n; ++k) {
+            const ofRectangle& r = out.crops[k].region;
+            const int cx = x - (int)r.x, cy = y - (int)r.y;
+            const int cw = (int)r.width, ch = (int)r.height;
+            if ((unsigned)cx >= (unsigned)cw || (unsigned)cy >= (unsigned)ch) continue;
+            planes_[plane_off_[k] + (e.pol ? 0 : (size_t)cw * ch) + (size_t)cy * cw + cx] += 1.f;
+        }
+    }
+    if (surfaceMapLastTs) {
+        decay_lut_.build(cfg.tau_ms * 1000.f);
+        for (size_t k = 0; k < n; ++k) {
+            const ofRectangle& r = out.crops[k].region;
+            const int cw = (int)r.width, ch = (int)r.height;
+            float* T = planes_.data() + plane_off_[k] + (size_t)2 * cw * ch;
+            for (int j = 0; j < ch; ++j)
+                simd::timeSurface(surfaceMapLastTs + (size_t)(r.y + j) * sW + (size_t)r.x, (size_t)cw,
+                                  (float)latest_ts, decay_lut_, T + (size_t)j * cw);
+        }
+    }
+
+    // Model channel c takes crop plane src[c]: C = 1 -> T, C = 2 -> pos/neg,
+    // C >= 3 -> pos/neg/T (VTEI order), the rest stay zero
+    int src[3] = {0, 1, 2};
+    if (model_C_ == 1) src[0] = 2;
+    const int used = std::min(model_C_, 3);
+
+    // Resample every crop into the zeroed batch tensor (padding stays 0)
+    const size_t mplane = (size_t)model_H_ * model_W_;
+    const size_t per = (size_t)model_C_ * mplane;
+    if (half_input_) { out.f32.clear(); out.f16.assign(n * per, 0); }
+    else             { out.f16.clear(); out.f32.assign(n * per, 0.f); }
+    const float count_scale = 5.0f;
+
+    for (size_t k = 0; k < n; ++k) {
+        RoiCrop& c = out.crops[k];
+        const int cw = (int)c.region.width, ch = (int)c.region.height;
+        plan_.ensure(cw, ch, model_W_, model_H_, cfg.resample);
+        c.scale = plan_.scale();
+        c.padx = plan_.padX();
+        c.pady = plan_.padY();
+        const size_t newW = (size_t)plan_.outW();
+        row_buf_.resize(newW);
+
+        for (int ci = 0; ci < used; ++ci) {
+            const float* sp = planes_.data() + plane_off_[k] + (size_t)src[ci] * cw * ch;
+            const bool counts = src[ci] < 2;
+            for (int j = 0; j < plan_.outH(); ++j) {
+                const size_t m = k * per + ci * mplane + (size_t)(j + c.pady) * model_W_ + c.padx;
+                float* d = half_input_ ? row_buf_.data() : out.f32.data() + m;
+                plan_.row(sp, j, d);
+                if (counts)
+                    for (size_t i = 0; i < newW; ++i) d[i] = std::min(1.f, d[i] / count_scale);
+                if (half_input_) simd::f32ToF16(d, out.f16.data() + m, newW);
+            }
+        }
+    }
+
+    out.epoch = epoch_;
+    last_crops_ = (int)n;
+    last_frac_ = std::min(1.f, area / ((float)sW * sH));
+    return true;
+}
+
+// ---- run ----
+RoiResult RoiPipeline::run(const RoiInput& in)
+{
+    RoiResult res;
+    res.epoch = in.epoch;
+    if (swap_pending_) return res;
+    std::lock_guard<std::mutex> lk(run_mu_);
+    if (!nn_ || !nn_->isLoaded() || in.crops.empty()) return res;
+
+    const size_t n = in.crops.size();
+    const size_t per = (size_t)model_C_ * model_H_ * model_W_;
+    if ((half_input_ ? in.f16.size() : in.f32.size()) != n * per) {
+        ofLogError() << "[RoiPipeline] crop batch has wrong size/precision";
+        return res;
+    }
+
+    cand_.clear();
+    try {
+        // Fixed batch-1 export: same work, one call per crop
+        const size_t B = nn_->supportsBatch() ? (size_t)std::max(1, cfg.batch_size) : 1;
+        const std::string out_name = nn_->outputs()[out_idx_].name;
+        const std::vector<int64_t> item_shape = itemShape();
+        std::vector<const void*> items;
+        for (size_t k0 = 0; k0 < n; k0 += B) {
+            const size_t m = std::min(B, n - k0);
+            items.clear();
+            for (size_t k = 0; k < m; ++k)
+                items.push_back(half_input_ ? (const void*)(in.f16.data() + (k0 + k) * per)
+                                            : (const void*)(in.f32.data() + (k0 + k) * per));
+
+            auto outs = nn_->runBatch(items, item_shape);
+            const auto& o = outs.at(out_name);
+            const size_t len = o.size() / m;
+            for (size_t k = 0; k < m; ++k) {
+                if (out_rank_ == 3) decodeBoxes_(o.data() + k * len, len, in.crops[k0 + k]);
+                else                decodeClass_(o.data() + k * len, len, in.crops[k0 + k], res.dets);
+            }
+        }
+    } catch (const std::exception& e) {
+        ofLogError() << "[RoiPipeline] inference error: " << e.what();
+        return res;
+    }
+
+    // Detector: one class-aware NMS over all crops (overlapping crops see
+    // the same object)
+    if (out_rank_ == 3) {
+        nn::nmsInPlace(cand_, cfg.iou_thresh, nms_ws_);
+        for (const auto& d : cand_)
+            res.dets.push_back(YoloDet{ofRectangle(d.x1, d.y1, d.x2 - d.x1, d.y2 - d.y1), d.score, d.cls});
+    }
+    return res;
+}
+
+// ---- decodeClass_ ----
+void RoiPipeline::decodeClass_(const float* v, size_t len, const RoiCrop& crop,
+                               std::vector<YoloDet>& out)
+{
+    if (len == 0) return;
+    const float maxv = *std::max_element(v, v + len);
+    probs_.resize(len);
+    float sum = 0.f;
+    for (size_t i = 0; i < len; ++i) sum += probs_[i] = std::exp(v[i] - maxv);
+    const size_t best = (size_t)(std::max_element(probs_.begin(), probs_.end()) - probs_.begin());
+    const float p = probs_[best] / sum;
+    if (p >= cfg.conf_thresh && crop.target.getWidth() > 0 && crop.target.getHeight() > 0)
+        out.push_back(YoloDet{crop.target, p, (int)best});
+}
+
+// ---- decodeBoxes_ ----
+void RoiPipeline::decodeBoxes_(const float* v, size_t len, const RoiCrop& crop)
+{
+    // [4 + nc, A]: C from the model when static, else from cfg.class_names
+    const int C = out_C_ > 0 ? out_C_ : 4 + std::max(1, (int)cfg.class_names.size());
+    if (C <= 4 || len % C != 0) {
+        ofLogError() << "[RoiPipeline] unexpected detector output length=" << len << " for C=" << C;
+        return;
+    }
+    const int nc = C - 4;
+    const int A = (int)(len / C);
+
+    // Best-class logit vs logit(conf_thresh), as in YoloPipeline::scoreFilter_
+    const float p = cfg.conf_thresh;
+    const float t = p <= 0.f ? -std::numeric_limits<float>::infinity()
+                  : p >= 1.f ?  std::numeric_limits<float>::infinity()
+                  : std::log(p / (1.f - p));
+    cls_max_.resize(A);
+    cls_arg_.resize(A);
+    simd::columnMaxArg(v + (size_t)4 * A, nc, (size_t)A, cls_max_.data(), cls_arg_.data());
+
+    const int cw = (int)crop.region.width, ch = (int)crop.region.height;
+    for (int i = 0; i < A; ++i) {
+        if (!(cls_max_[i] >= t)) continue;
+        const float score = nn::sigmoid(cls_max_[i]);
+        if (score < cfg.conf_thresh) continue;
+        const float cx = v[i], cy = v[(size_t)A + i];
+        const float w = v[(size_t)2 * A + i], h = v[(size_t)3 * A + i];
+        if (w <= 1.f || h <= 1.f) continue;
+
+        // Model -> crop -> sensor
+        const ofRectangle r = nn::unletterboxToSensor(cx - 0.5f * w, cy - 0.5f * h,
+                                                      cx + 0.5f * w, cy + 0.5f * h,
+                                                      crop.scale, crop.padx, crop.pady, cw, ch);
+        if (r.getWidth() <= 0 || r.getHeight() <= 0) continue;
+        nn::Det d;
+        d.x1 = crop.region.x + r.x;
+        d.y1 = crop.region.y + r.y;
+        d.x2 = d.x1 + r.getWidth();
+        d.y2 = d.y1 + r.getHeight();
+        d.score = score;
+        d.cls = cls_arg_[i];
+        cand_.push_back(d);
+    }
+}
+
+// ---- applyResult ----
+void RoiPipeline::applyResult(const RoiResult& r) {
+    if (r.epoch != epoch_) return;
+    dets_ = r.dets;
+}
+
+// ---- drawDetections ----
+void RoiPipeline::drawDetections(int sensorW, int sensorH) const {
+    if (!cfg.draw || dets_.empty()) return;
+
+    ofPushStyle();
+    ofDisableDepthTest();
+    ofNoFill();
+    ofSetColor(0, 200, 255);
+    ofSetLineWidth(2.0f);
+
+    ofPushMatrix();
+    ofScale(ofGetWidth() / (float)sensorW, ofGetHeight() / (float)sensorH);
+    ofScale(1.0f, -1.0f);
+    ofTranslate(0.0f, -(float)sensorH);
+
+    for (const auto& d : dets_) {
+        ofDrawRectangle(d.box);
+        if (!cfg.show_labels) continue;
+
+        std::string name = (d.cls >= 0 && d.cls < (int)cfg.class_names.size())
+                           ? cfg.class_names[d.cls]
+                           : ("id:" + ofToString(d.cls));
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "%s %.2f", name.c_str(), d.score);
+
+        ofPushMatrix();
+        ofTranslate(d.box.getX() + 2, d.box.getY() + d.box.getHeight() - 4);
+        ofScale(1.0f, -1.0f);
+        ofDrawBitmapStringHighlight(buf, 0, 0, ofColor(0,0,0,180), ofColor(0,200,255));
+        ofPopMatrix();
+    }
+
+    ofPopMatrix();
+    ofPopStyle();
+}
+
+// ---- clearHistory ----
+void RoiPipeline::clearHistory() {
+    dets_.clear();
+    ++epoch_;
+    gate.reset();
+}
+
+} // namespace dvs
@@ -0,0 +1,193 @@
+#pragma once
+/// @file dvs_roi_pipeline.hpp
+/// @brief Region-of-interest inference on the RectangularClusterTracker's
+///        visible clusters.
+///
+/// Instead of letterboxing the whole sensor into a detector, the pipeline
+/// cuts a few small patches where the cluster tracker sees activity and runs
+/// a small model on those only.  Crops are either fixed-size squares centred
+/// on each cluster, or the merged bounds of nearby clusters (letterboxed to
+/// the model input).  Crop channels are built for the cropped pixels only:
+/// ON / OFF event counts and the SAE time surface, in VTEI channel order
+/// (pos, neg, T); a model with more channels gets the rest zero-filled.
+/// All crops of a frame go to ORT as one [n, C, H, W] call.
+///
+/// The output decides how results are read: a rank-2 [n, K] output is a
+/// classifier (one label per crop, boxed by the cluster bounds), a rank-3
+/// [n, 4 + nc, A] output is a YOLO-style detector whose boxes are mapped
+/// back to sensor coordinates and NMS'd across crops.
+///
+/// prepare() runs on the main thread; run() can run on an InferenceWorker.
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+
+#include "ofMain.h"
+#include "onnx_run.hpp"
+#include "dvs_model_loader.hpp"
+#include "dvs_activity_gate.hpp"
+#include "dvs_nn_utils.hpp"
+#include "dvs_yolo_pipeline.hpp"
+
+struct polarity;
+
+namespace dvs {
+
+/// Runtime-tunable ROI configuration.
+struct RoiConfig {
+    bool  merge        = false;   ///< crop merged cluster bounds instead of fixed patches
+    int   crop_px      = 64;      ///< fixed-patch side in sensor pixels
+    float merge_margin = 0.2f;    ///< merged mode: bounds grown by this fraction per side before merging
+    int   max_crops    = 8;       ///< largest clusters first
+    int   batch_size   = 8;       ///< crops per ORT call (fixed batch-1 exports run one at a time)
+    float conf_thresh  = 0.5f;
+    float iou_thresh   = 0.45f;
+    float win_ms       = 50.f;    ///< event-count channels: window before the newest event
+    float tau_ms       = 500.f;   ///< time-surface decay (as in the YOLO VTEI)
+    nn::ResampleMode resample = nn::ResampleMode::Area;  ///< crop -> model resampling
+    bool  draw         = true;
+    bool  show_labels  = true;
+    std::vector<std::string> class_names;
+};
+
+/// One crop: the sensor pixels cut out and how they map to the model input.
+struct RoiCrop {
+    ofRectangle region;           ///< cropped sensor pixels (integer-aligned)
+    ofRectangle target;           ///< cluster (or merged) bounds, the box of a classifier result
+    float scale = 1.f;            ///< crop -> model letterbox
+    int   padx = 0, pady = 0;
+};
+
+/// Crop batch handed from the main thread to the inference worker.
+struct RoiInput {
+    std::vector<float>    f32;    ///< [n, C, H, W] for float32 models...
+    std::vector<uint16_t> f16;    ///< ...or binary16 bits for float16 models
+    std::vector<RoiCrop>  crops;
+    unsigned epoch = 0;
+};
+
+/// Detections produced by run(), in sensor coordinates.
+struct RoiResult {
+    std::vector<YoloDet> dets;
+    unsigned epoch = 0;
+};
+
+class RoiPipeline {
+public:
+    RoiPipeline() = default;
+
+    /// Load the ONNX model synchronously (blocks until ready).
+    void loadModel(const std::string& path, int threads = 0);
+
+    /// Start loading a model on a background thread; see YoloPipeline.
+    /// @return false if a load is already in progress.
+    bool loadModelAsync(const std::string& path, int threads = 0);
+
+    /// Main thread, once per frame: install a finished background load
+    /// without blocking.  @return true when a new model was installed.
+    bool pollLoad();
+
+    LoadState loadState() const;
+    const std::string& loadError() const { return loader_.error(); }
+    const std::string& modelPath() const { return model_path_; }
+
+    bool isLoaded() const { return nn_ && nn_->isLoaded(); }
+
+    /// Main-thread half: pick crops around `clusters` (sensor-pixel bounds,
+    /// e.g. RectangularClusterTracker::getVisibleClusterBounds()), build
+    /// their channels and resample them into the model-input batch.
+    /// @return true if `out` holds at least one crop.
+    bool prepare(const std::vector<ofRectangle>& clusters,
+                 const std::vector<polarity>& events,
+                 const float* surfaceMapLastTs,      ///< row-major sensorH x sensorW, may be null
+                 int sensorW, int sensorH, RoiInput& out);
+
+    /// Worker half: run all crops in batches of cfg.batch_size and decode.
+    /// Touches no main-thread state; call from one thread at a time.
+    RoiResult run(const RoiInput& in);
+
+    /// Publish a worker result (main thread); results from before the last
+    /// clearHistory() are ignored.
+    void applyResult(const RoiResult& r);
+
+    /// Draw the ROI results in sensor coordinates (same transform as
+    /// YoloPipeline::drawDetections).
+    void drawDetections(int sensorW, int sensorH) const;
+
+    void clearHistory();
+
+    const std::vector<YoloDet>& detections() const { return dets_; }
+
+    /// Crops of the last prepare() and the fraction of the sensor they cover.
+    int   lastCrops()    const { return last_crops_; }
+    float cropFraction() const { return last_frac_; }
+
+    RoiConfig cfg;
+
+    /// Activity gate consulted by the caller before prepare() and committed
+    /// when prepare() returns true (main thread).
+    ActivityGate gate;
+
+    OnnxRunner* runner() { return nn_.get(); }
+
+    /// Shape of one crop ([1, C, H, W]).
+    std::vector<int64_t> itemShape() const {
+        return {1, (int64_t)model_C_, (int64_t)model_H_, (int64_t)model_W_};
+    }
+
+private:
+    static OnnxRunner::Config runnerConfig_(const std::string& path, int threads);
+
+    /// Adopt a loaded runner (caller holds run_mu_ or no worker is running).
+    void install_(std::unique_ptr<OnnxRunner> runner);
+
+    /// Crop regions for this frame, largest first, at most cfg.max_crops.
+    void selectCrops_(const std::vector<ofRectangle>& clusters, int sW, int sH,
+                      std::vector<RoiCrop>& crops) const;
+
+    /// Append crop k's score-filtered detector boxes (sensor coords) to cand_.
+    void decodeBoxes_(const float* v, size_t len, const RoiCrop& crop);
+
+    /// Crop k's classifier result, if its best class passes conf_thresh.
+    void decodeClass_(const float* v, size_t len, const RoiCrop& crop, std::vector<YoloDet>& out);
+
+    std::unique_ptr<OnnxRunner> nn_;
+    std::string model_path_;
+
+    // Background load / hot swap
+    ModelLoader loader_;
+    std::unique_ptr<OnnxRunner> pending_;
+    std::atomic<bool> swap_pending_{false};
+    std::mutex run_mu_;
+
+    // Model geometry (filled on load)
+    int  model_C_ = 0, model_H_ = 0, model_W_ = 0;
+    bool half_input_ = false;
+    int  out_idx_ = 0;
+    int  out_rank_ = 0;                          ///< 2 = classifier, 3 = detector
+    int  out_C_ = 0;                             ///< detector: 4 + nc (0 = from output size)
+
+    // prepare() scratch (main thread)
+    nn::ResamplePlan plan_;                      ///< crop -> model, cached per crop size
+    simd::DecayLUT decay_lut_;
+    std::vector<float> planes_;                  ///< pos / neg / T of every crop, back to back
+    std::vector<size_t> plane_off_;
+    std::vector<float> row_buf_;                 ///< one resampled row (f16 path)
+
+    // run() scratch (under run_mu_)
+    std::vector<float>   cls_max_;
+    std::vector<int32_t> cls_arg_;
+    std::vector<nn::Det> cand_;                  ///< all crops' boxes, NMS'd together
+    nn::NmsWorkspace     nms_ws_;
+    std::vector<float>   probs_;
+
+    std::vector<YoloDet> dets_;
+    unsigned epoch_ = 0;                         ///< bumped by clearHistory()
+    int   last_crops_ = 0;
+    float last_frac_ = 0.f;
+};
+
+} // namespace dvs
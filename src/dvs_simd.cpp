@@ -0,0 +1,915 @@
+#include "dvs_simd.hpp"
+#include "ofMain.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define DVS_SIMD_X86 1
+#include <immintrin.h>
+#define DVS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#define DVS_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace dvs {
+namespace simd {
+
+// Grayscale weights and edge scale shared by every path, so all ISAs agree
+// bit for bit with the scalar reference.
+static constexpr float kWr = 0.299f, kWg = 0.587f, kWb = 0.114f;
+static constexpr float kEdgeScale = 1.0f / (4.0f * 255.0f);
+static constexpr float kInv255 = 1.0f / 255.0f;
+
+// ---- ISA selection ----
+static std::atomic<bool> g_force_scalar{false};
+
+Isa detectedIsa() {
+    static const Isa isa = [] {
+#if defined(DVS_SIMD_X86)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+#endif
+#if defined(DVS_SIMD_NEON)
+        return Isa::NEON;
+#endif
+        return Isa::Scalar;
+    }();
+    return isa;
+}
+
+Isa activeIsa() {
+    return g_force_scalar.load(std::memory_order_relaxed) ? Isa::Scalar : detectedIsa();
+}
+
+void forceScalar(bool on) { g_force_scalar.store(on); }
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::AVX2: return "AVX2";
+        case Isa::NEON: return "NEON";
+        default:        return "scalar";
+    }
+}
+
+// ---- DecayLUT ----
+void DecayLUT::build(float tau, int entries, float span_taus) {
+    entries = std::max(2, entries);
+    if (tau == tau_us && (int)table.size() == entries + 1) return;
+    tau_us = tau;
+    const float step = span_taus * tau / entries;
+    inv_step = 1.0f / step;
+    table.resize(entries + 1);
+    for (int i = 0; i < entries; ++i)
+        table[i] = std::exp(-(i * step) / tau);
+    table[entries] = 0.f;   // saturated: older than the table span
+}
+
+// ---- timeSurface ----
+static inline void timeSurfaceScalar(const float* ts, size_t b, size_t n, float latest,
+                                     const DecayLUT& lut, float* out) {
+    const float last = (float)(lut.table.size() - 1);
+    const float* tab = lut.table.data();
+    for (size_t i = b; i < n; ++i) {
+        float dt = std::max(0.f, latest - ts[i]);
+        out[i] = tab[(int)std::min(dt * lut.inv_step, last)];
+    }
+}
+
+#if defined(DVS_SIMD_X86)
+DVS_TARGET_AVX2
+static size_t timeSurfaceAVX2(const float* ts, size_t n, float latest,
+                              const DecayLUT& lut, float* out) {
+    const __m256 vlatest = _mm256_set1_ps(latest);
+    const __m256 vinv    = _mm256_set1_ps(lut.inv_step);
+    const __m256 vlast   = _mm256_set1_ps((float)(lut.table.size() - 1));
+    const __m256 vzero   = _mm256_setzero_ps();
+    const float* tab = lut.table.data();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 dt = _mm256_max_ps(vzero, _mm256_sub_ps(vlatest, _mm256_loadu_ps(ts + i)));
+        __m256i idx = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_mul_ps(dt, vinv), vlast));
+        _mm256_storeu_ps(out + i, _mm256_i32gather_ps(tab, idx, 4));
+    }
+    return i;
+}
+#endif
+
+#if defined(DVS_SIMD_NEON)
+static size_t timeSurfaceNEON(const float* ts, size_t n, float latest,
+                              const DecayLUT& lut, float* out) {
+    const float32x4_t vlatest = vdupq_n_f32(latest);
+    const float32x4_t vinv    = vdupq_n_f32(lut.inv_step);
+    const float32x4_t vlast   = vdupq_n_f32((float)(lut.table.size() - 1));
+    const float32x4_t vzero   = vdupq_n_f32(0.f);
+    const float* tab = lut.table.data();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t dt = vmaxq_f32(vzero, vsubq_f32(vlatest, vld1q_f32(ts + i)));
+        int32x4_t idx = vcvtq_s32_f32(vminq_f32(vmulq_f32(dt, vinv), vlast));
+        // No gather on NEON: index math is vectorized, lookups are not
+        out[i + 0] = tab[vgetq_lane_s32(idx, 0)];
+        out[i + 1] = tab[vgetq_lane_s32(idx, 1)];
+        out[i + 2] = tab[vgetq_lane_s32(idx, 2)];
+        out[i + 3] = tab[vgetq_lane_s32(idx, 3)];
+    }
+    return i;
+}
+#endif
+
+void timeSurface(const float* ts, size_t n, float latest, const DecayLUT& lut, float* out) {
+    if (lut.table.empty()) { std::fill(out, out + n, 0.f); return; }
+    size_t done = 0;
+    switch (activeIsa()) {
+#if defined(DVS_SIMD_X86)
+        case Isa::AVX2: done = timeSurfaceAVX2(ts, n, latest, lut, out); break;
+#endif
+#if defined(DVS_SIMD_NEON)
+        case Isa::NEON: done = timeSurfaceNEON(ts, n, latest, lut, out); break;
+#endif
+        default: break;
+    }
+    timeSurfaceScalar(ts, done, n, latest, lut, out);
+}
+
+// ---- grayscale row ----
+static inline void grayRowScalar(const uint8_t* src, int nc, size_t b, size_t n, uint8_t* dst) {
+    if (nc < 3) {
+        for (size_t i = b; i < n; ++i) dst[i] = src[i * nc];
+        return;
+    }
+    for (size_t i = b; i < n; ++i) {
+        const uint8_t* p = src + i * nc;
+        dst[i] = (uint8_t)(kWr * p[0] + kWg * p[1] + kWb * p[2]);
+    }
+}
+
+#if defined(DVS_SIMD_X86)
+DVS_TARGET_AVX2
+static size_t grayRowAVX2(const uint8_t* src, int nc, size_t n, uint8_t* dst) {
+    if (nc < 3) return 0;
+    // One 32-bit gather per pixel picks up R, G, B (and one byte beyond);
+    // stop while the last lane's 4-byte read stays inside the row.
+    const __m256i offs = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                            _mm256_set1_epi32(nc));
+    const __m256i m8 = _mm256_set1_epi32(0xff);
+    const __m256 wr = _mm256_set1_ps(kWr), wg = _mm256_set1_ps(kWg), wb = _mm256_set1_ps(kWb);
+    size_t i = 0;
+    for (; (i + 8) * nc + 1 <= n * nc; i += 8) {
+        __m256i v = _mm256_i32gather_epi32((const int*)(src + i * nc), offs, 1);
+        __m256 r = _mm256_cvtepi32_ps(_mm256_and_si256(v, m8));
+        __m256 g = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(v, 8), m8));
+        __m256 b = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(v, 16), m8));
+        __m256 y = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(wr, r), _mm256_mul_ps(wg, g)),
+                                 _mm256_mul_ps(wb, b));
+        __m256i yi = _mm256_cvttps_epi32(y);
+        // 8 x int32 -> 8 x uint8
+        __m128i lo = _mm256_castsi256_si128(yi), hi = _mm256_extracti128_si256(yi, 1);
+        __m128i w16 = _mm_packus_epi32(lo, hi);
+        _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(w16, w16));
+    }
+    return i;
+}
+#endif
+
+#if defined(DVS_SIMD_NEON)
+static inline float32x4_t u16lo_f32(uint16x8_t v) { return vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))); }
+static inline float32x4_t u16hi_f32(uint16x8_t v) { return vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))); }
+
+static size_t grayRowNEON(const uint8_t* src, int nc, size_t n, uint8_t* dst) {
+    if (nc != 3 && nc != 4) return 0;
+    const float32x4_t wr = vdupq_n_f32(kWr), wg = vdupq_n_f32(kWg), wb = vdupq_n_f32(kWb);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint8x8_t r8, g8, b8;
+        if (nc == 3) { uint8x8x3_t px = vld3_u8(src + i * 3); r8 = px.val[0]; g8 = px.val[1]; b8 = px.val[2]; }
+        else         { uint8x8x4_t px = vld4_u8(src + i * 4); r8 = px.val[0]; g8 = px.val[1]; b8 = px.val[2]; }
+        uint16x8_t r = vmovl_u8(r8), g = vmovl_u8(g8), b = vmovl_u8(b8);
+        float32x4_t y0 = vaddq_f32(vaddq_f32(vmulq_f32(wr, u16lo_f32(r)), vmulq_f32(wg, u16lo_f32(g))),
+                                   vmulq_f32(wb, u16lo_f32(b)));
+        float32x4_t y1 = vaddq_f32(vaddq_f32(vmulq_f32(wr, u16hi_f32(r)), vmulq_f32(wg, u16hi_f32(g))),
+                                   vmulq_f32(wb, u16hi_f32(b)));
+        uint16x8_t y16 = vcombine_u16(vmovn_u32(vcvtq_u32_f32(y0)), vmovn_u32(vcvtq_u32_f32(y1)));
+        vst1_u8(dst + i, vmovn_u16(y16));
+    }
+    return i;
+}
+#endif
+
+// ---- Sobel + intensity row ----
+static inline void edgeRowScalar(const uint8_t* up, const uint8_t* mid, const uint8_t* dn,
+                                 int b, int e, float* edge) {
+    for (int x = b; x < e; ++x) {
+        float gx = float((up[x+1] + 2*mid[x+1] + dn[x+1]) - (up[x-1] + 2*mid[x-1] + dn[x-1]));
+        float gy = float((dn[x-1] + 2*dn[x] + dn[x+1]) - (up[x-1] + 2*up[x] + up[x+1]));
+        edge[x] = std::min(1.f, std::sqrt(gx*gx + gy*gy) * kEdgeScale);
+    }
+}
+
+#if defined(DVS_SIMD_X86)
+DVS_TARGET_AVX2
+static inline __m256 load8u_ps(const uint8_t* p) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)p)));
+}
+
+DVS_TARGET_AVX2
+static int edgeRowAVX2(const uint8_t* up, const uint8_t* mid, const uint8_t* dn,
+                       int W, float* edge) {
+    const __m256 two = _mm256_set1_ps(2.f), one = _mm256_set1_ps(1.f);
+    const __m256 scale = _mm256_set1_ps(kEdgeScale);
+    int x = 1;
+    for (; x + 8 <= W - 1; x += 8) {
+        __m256 ul = load8u_ps(up + x - 1),  uc = load8u_ps(up + x),  ur = load8u_ps(up + x + 1);
+        __m256 ml = load8u_ps(mid + x - 1),                          mr = load8u_ps(mid + x + 1);
+        __m256 dl = load8u_ps(dn + x - 1),  dc = load8u_ps(dn + x),  dr = load8u_ps(dn + x + 1);
+        __m256 gx = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(ur, _mm256_mul_ps(two, mr)), dr),
+                                  _mm256_add_ps(_mm256_add_ps(ul, _mm256_mul_ps(two, ml)), dl));
+        __m256 gy = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(dl, _mm256_mul_ps(two, dc)), dr),
+                                  _mm256_add_ps(_mm256_add_ps(ul, _mm256_mul_ps(two, uc)), ur));
+        __m256 mag = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(gx, gx), _mm256_mul_ps(gy, gy)));
+        _mm256_storeu_ps(edge + x, _mm256_min_ps(one, _mm256_mul_ps(mag, scale)));
+    }
+    return x;
+}
+
+DVS_TARGET_AVX2
+static int intensityRowAVX2(const uint8_t* g, int W, float* out) {
+    const __m256 s = _mm256_set1_ps(kInv255);
+    int x = 0;
+    for (; x + 8 <= W; x += 8)
+        _mm256_storeu_ps(out + x, _mm256_mul_ps(load8u_ps(g + x), s));
+    return x;
+}
+#endif
+
+#if defined(DVS_SIMD_NEON)
+static int edgeRowNEON(const uint8_t* up, const uint8_t* mid, const uint8_t* dn,
+                       int W, float* edge) {
+    const float32x4_t two = vdupq_n_f32(2.f), one = vdupq_n_f32(1.f);
+    const float32x4_t scale = vdupq_n_f32(kEdgeScale);
+    int x = 1;
+    for (; x + 4 <= W - 1; x += 4) {
+        auto ld = [](const uint8_t* p) {
+            // exactly 4 bytes: p + 3 <= x + 4 <= W - 1 stays in the row
+            uint32_t w;
+            std::memcpy(&w, p, 4);
+            uint8x8_t v = vreinterpret_u8_u32(vdup_n_u32(w));
+            return vcvtq_f32_u32(vmovl_u16(vget_low_u16(vmovl_u8(v))));
+        };
+        float32x4_t ul = ld(up + x - 1),  uc = ld(up + x),  ur = ld(up + x + 1);
+        float32x4_t ml = ld(mid + x - 1),                   mr = ld(mid + x + 1);
+        float32x4_t dl = ld(dn + x - 1),  dc = ld(dn + x),  dr = ld(dn + x + 1);
+        float32x4_t gx = vsubq_f32(vaddq_f32(vaddq_f32(ur, vmulq_f32(two, mr)), dr),
+                                   vaddq_f32(vaddq_f32(ul, vmulq_f32(two, ml)), dl));
+        float32x4_t gy = vsubq_f32(vaddq_f32(vaddq_f32(dl, vmulq_f32(two, dc)), dr),
+                                   vaddq_f32(vaddq_f32(ul, vmulq_f32(two, uc)), ur));
+        float32x4_t mag = vsqrtq_f32(vaddq_f32(vmulq_f32(gx, gx), vmulq_f32(gy, gy)));
+        vst1q_f32(edge + x, vminq_f32(one, vmulq_f32(mag, scale)));
+    }
+    return x;
+}
+#endif
+
+// ---- grayEdgeIntensity (fused) ----
+void grayEdgeIntensity(const uint8_t* src, int nc, int W, int H,
+                       uint8_t* gray, float* edge, float* intensity) {
+    if (W <= 0 || H <= 0) return;
+    const Isa isa = activeIsa();
+    const size_t rowBytes = (size_t)W * nc;
+
+    auto grayRow = [&](int y) {
+        const uint8_t* s = src + y * rowBytes;
+        uint8_t* d = gray + (size_t)y * W;
+        size_t done = 0;
+#if defined(DVS_SIMD_X86)
+        if (isa == Isa::AVX2) done = grayRowAVX2(s, nc, W, d);
+#endif
+#if defined(DVS_SIMD_NEON)
+        if (isa == Isa::NEON) done = grayRowNEON(s, nc, W, d);
+#endif
+        grayRowScalar(s, nc, done, W, d);
+    };
+
+    grayRow(0);
+    if (H > 1) grayRow(1);
+
+    for (int y = 0; y < H; ++y) {
+        // Keep grayscale one row ahead of the Sobel row
+        if (y + 2 < H) grayRow(y + 2);
+
+        const uint8_t* g = gray + (size_t)y * W;
+        float* e = edge + (size_t)y * W;
+        float* in = intensity + (size_t)y * W;
+
+        int x = 0;
+#if defined(DVS_SIMD_X86)
+        if (isa == Isa::AVX2) x = intensityRowAVX2(g, W, in);
+#endif
+        for (; x < W; ++x) in[x] = g[x] * kInv255;
+
+        if (y == 0 || y == H - 1 || W < 3) {
+            std::fill(e, e + W, 0.f);
+            continue;
+        }
+        e[0] = 0.f;
+        e[W - 1] = 0.f;
+        const uint8_t* up = g - W;
+        const uint8_t* dn = g + W;
+        int xs = 1;
+#if defined(DVS_SIMD_X86)
+        if (isa == Isa::AVX2) xs = edgeRowAVX2(up, g, dn, W, e);
+#endif
+#if defined(DVS_SIMD_NEON)
+        if (isa == Isa::NEON) xs = edgeRowNEON(up, g, dn, W, e);
+#endif
+        edgeRowScalar(up, g, dn, xs, W - 1, e);
+    }
+}
+
+// ---- FP16 conversion ----
+bool hasF16C() {
+    static const bool ok = [] {
+#if defined(DVS_SIMD_X86)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("f16c") && __builtin_cpu_supports("avx");
+#else
+        return false;
+#endif
+    }();
+    return ok && !g_force_scalar.load(std::memory_order_relaxed);
+}
+
+static inline uint16_t f32ToF16Scalar(float f) {
+    uint32_t x; std::memcpy(&x, &f, sizeof(x));
+    const uint32_t sign = (x >> 16) & 0x8000;
+    const uint32_t fexp = (x >> 23) & 0xFF;
+    uint32_t mant = x & 0x7FFFFF;
+
+    if (fexp == 0xFF)                                   // Inf / NaN (quieted)
+        return uint16_t(sign | 0x7C00 | (mant ? 0x200 | (mant >> 13) : 0));
+    const int32_t exp = int32_t(fexp) - 127 + 15;
+    if (exp >= 31) return uint16_t(sign | 0x7C00);      // finite overflow -> Inf
+
+    // Round to nearest even, like F16C / NEON
+    if (exp <= 0) {
+        if (exp < -10) return uint16_t(sign);
+        mant |= 0x800000;
+        const int shift = 14 - exp;
+        uint32_t h = mant >> shift;
+        const uint32_t rem = mant & ((1u << shift) - 1), half = 1u << (shift - 1);
+        if (rem > half || (rem == half && (h & 1))) ++h;
+        return uint16_t(sign | h);
+    }
+    uint32_t h = (uint32_t(exp) << 10) | (mant >> 13);
+    const uint32_t rem = mant & 0x1FFF;
+    if (rem > 0x1000 || (rem == 0x1000 && (h & 1))) ++h;   // a carry bumps the exponent (up to Inf)
+    return uint16_t(sign | h);
+}
+
+static inline float f16ToF32Scalar(uint16_t h) {
+    uint32_t sign = (h >> 15) & 0x1;
+    uint32_t exp  = (h >> 10) & 0x1F;
+    uint32_t mant = h & 0x3FF;
+    uint32_t x;
+
+    if (exp == 0) {
+        if (mant == 0) { x = sign << 31; }
+        else {
+            exp = 127 - 15 + 1;
+            while ((mant & 0x400) == 0) { mant <<= 1; --exp; }
+            mant &= 0x3FF;
+            x = (sign << 31) | (exp << 23) | (mant << 13);
+        }
+    } else if (exp == 31) {
+        x = (sign << 31) | (0xFF << 23) | (mant ? 0x400000 | (mant << 13) : 0);  // quiet NaN, payload kept
+    } else {
+        x = (sign << 31) | ((exp - 15 + 127) << 23) | (mant << 13);
+    }
+    float f; std::memcpy(&f, &x, sizeof(f)); return f;
+}
+
+#if defined(DVS_SIMD_X86)
+__attribute__((target("avx,f16c")))
+static size_t f32ToF16_F16C(const float* src, uint16_t* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)(dst + i), h);
+    }
+    return i;
+}
+
+__attribute__((target("avx,f16c")))
+static size_t f16ToF32_F16C(const uint16_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i))));
+    return i;
+}
+#endif
+
+#if defined(__aarch64__)
+static size_t f32ToF16_NEON(const float* src, uint16_t* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+    return i;
+}
+
+static size_t f16ToF32_NEON(const uint16_t* src, float* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+    return i;
+}
+#endif
+
+void f32ToF16(const float* src, uint16_t* dst, size_t n) {
+    size_t i = 0;
+#if defined(DVS_SIMD_X86)
+    if (hasF16C()) i = f32ToF16_F16C(src, dst, n);
+#elif defined(__aarch64__)
+    if (activeIsa() == Isa::NEON) i = f32ToF16_NEON(src, dst, n);
+#endif
+    for (; i < n; ++i) dst[i] = f32ToF16Scalar(src[i]);
+}
+
+void f16ToF32(const uint16_t* src, float* dst, size_t n) {
+    size_t i = 0;
+#if defined(DVS_SIMD_X86)
+    if (hasF16C()) i = f16ToF32_F16C(src, dst, n);
+#elif defined(__aarch64__)
+    if (activeIsa() == Isa::NEON) i = f16ToF32_NEON(src, dst, n);
+#endif
+    for (; i < n; ++i) dst[i] = f16ToF32Scalar(src[i]);
+}
+
+void benchmarkF16() {
+    using clk = std::chrono::steady_clock;
+    const size_t n = (size_t)5 * 288 * 352;
+    const int reps = 50;
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> val(0.f, 1.f);
+    std::vector<float> src(n), back0(n), back1(n);
+    for (auto& v : src) v = val(rng);
+    std::vector<uint16_t> h0(n), h1(n);
+
+    auto ms = [&](clk::time_point a, clk::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count() / reps;
+    };
+
+    const bool wasForced = g_force_scalar.load();
+    forceScalar(true);
+    auto t0 = clk::now();
+    for (int r = 0; r < reps; ++r) f32ToF16(src.data(), h0.data(), n);
+    auto t1 = clk::now();
+    for (int r = 0; r < reps; ++r) f16ToF32(h0.data(), back0.data(), n);
+    auto t2 = clk::now();
+    forceScalar(wasForced);
+
+    const char* path = hasF16C() ? "F16C" : isaName(activeIsa());
+    for (int r = 0; r < reps; ++r) f32ToF16(src.data(), h1.data(), n);
+    auto t3 = clk::now();
+    for (int r = 0; r < reps; ++r) f16ToF32(h1.data(), back1.data(), n);
+    auto t4 = clk::now();
+
+    size_t ulpDiff = 0;
+    float err0 = 0.f, err1 = 0.f;
+    for (size_t i = 0; i < n; ++i) {
+        if (h0[i] != h1[i]) ++ulpDiff;
+        err0 = std::max(err0, std::abs(back0[i] - src[i]));
+        err1 = std::max(err1, std::abs(back1[i] - src[i]));
+    }
+
+    ofLogNotice() << "[FP16 bench] " << n << " values (5x288x352)";
+    ofLogNotice() << "[FP16 bench]   f32->f16 scalar " << ms(t0, t1) << " ms, "
+                  << path << " " << ms(t2, t3) << " ms";
+    ofLogNotice() << "[FP16 bench]   f16->f32 scalar " << ms(t1, t2) << " ms, "
+                  << path << " " << ms(t3, t4) << " ms";
+    ofLogNotice() << "[FP16 bench]   round-trip max err scalar " << err0 << ", " << path << " " << err1
+                  << "; " << ulpDiff << " halves differ by rounding";
+}
+
+// ---- columnMaxArg ----
+static inline void columnMaxArgScalar(const float* src, int rows, size_t b, size_t n,
+                                      float* max_out, int32_t* arg_out) {
+    for (size_t i = b; i < n; ++i) {
+        float m = src[i]; int32_t a = 0;
+        for (int r = 1; r < rows; ++r) {
+            const float v = src[(size_t)r * n + i];
+            if (v > m) { m = v; a = r; }
+        }
+        max_out[i] = m;
+        arg_out[i] = a;
+    }
+}
+
+#if defined(DVS_SIMD_X86)
+DVS_TARGET_AVX2
+static size_t columnMaxArgAVX2(const float* src, int rows, size_t n,
+                               float* max_out, int32_t* arg_out) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 m = _mm256_loadu_ps(src + i);
+        __m256i a = _mm256_setzero_si256();
+        for (int r = 1; r < rows; ++r) {
+            __m256 v = _mm256_loadu_ps(src + (size_t)r * n + i);
+            __m256 gt = _mm256_cmp_ps(v, m, _CMP_GT_OQ);   // strict: first max wins
+            m = _mm256_blendv_ps(m, v, gt);
+            a = _mm256_blendv_epi8(a, _mm256_set1_epi32(r), _mm256_castps_si256(gt));
+        }
+        _mm256_storeu_ps(max_out + i, m);
+        _mm256_storeu_si256((__m256i*)(arg_out + i), a);
+    }
+    return i;
+}
+#endif
+
+#if defined(DVS_SIMD_NEON)
+static size_t columnMaxArgNEON(const float* src, int rows, size_t n,
+                               float* max_out, int32_t* arg_out) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t m = vld1q_f32(src + i);
+        int32x4_t a = vdupq_n_s32(0);
+        for (int r = 1; r < rows; ++r) {
+            float32x4_t v = vld1q_f32(src + (size_t)r * n + i);
+            uint32x4_t gt = vcgtq_f32(v, m);
+            m = vbslq_f32(gt, v, m);
+            a = vbslq_s32(gt, vdupq_n_s32(r), a);
+        }
+        vst1q_f32(max_out + i, m);
+        vst1q_s32(arg_out + i, a);
+    }
+    return i;
+}
+#endif
+
+void columnMaxArg(const float* src, int rows, size_t n, float* max_out, int32_t* arg_out) {
+    if (rows <= 0) return;
+    size_t done = 0;
+    switch (activeIsa()) {
+#if defined(DVS_SIMD_X86)
+        case Isa::AVX2: done = columnMaxArgAVX2(src, rows, n, max_out, arg_out); break;
+#endif
+#if defined(DVS_SIMD_NEON)
+        case Isa::NEON: done = columnMaxArgNEON(src, rows, n, max_out, arg_out); break;
+#endif
+        default: break;
+    }
+    columnMaxArgScalar(src, rows, done, n, max_out, arg_out);
+}
+
+// ---- resampling rows ----
+static inline void weightedSumScalar(const float* const* rows, const float* w, int k,
+                                     size_t b, size_t n, float* dst) {
+    for (size_t x = b; x < n; ++x) {
+        float v = w[0] * rows[0][x];
+        for (int r = 1; r < k; ++r) v += w[r] * rows[r][x];
+        dst[x] = v;
+    }
+}
+
+static inline void gatherWeightedScalar(const float* src, const int32_t* idx, const float* w,
+                                        int k, size_t b, size_t n, float* dst) {
+    for (size_t i = b; i < n; ++i) {
+        float v = w[i] * src[idx[i]];
+        for (int t = 1; t < k; ++t) v += w[t * n + i] * src[idx[t * n + i]];
+        dst[i] = v;
+    }
+}
+
+#if defined(DVS_SIMD_X86)
+DVS_TARGET_AVX2
+static size_t weightedSumAVX2(const float* const* rows, const float* w, int k,
+                              size_t n, float* dst) {
+    size_t x = 0;
+    for (; x + 8 <= n; x += 8) {
+        __m256 v = _mm256_mul_ps(_mm256_set1_ps(w[0]), _mm256_loadu_ps(rows[0] + x));
+        for (int r = 1; r < k; ++r)
+            v = _mm256_add_ps(v, _mm256_mul_ps(_mm256_set1_ps(w[r]), _mm256_loadu_ps(rows[r] + x)));
+        _mm256_storeu_ps(dst + x, v);
+    }
+    return x;
+}
+
+DVS_TARGET_AVX2
+static size_t gatherWeightedAVX2(const float* src, const int32_t* idx, const float* w,
+                                 int k, size_t n, float* dst) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i ix = _mm256_loadu_si256((const __m256i*)(idx + i));
+        __m256 v = _mm256_mul_ps(_mm256_loadu_ps(w + i), _mm256_i32gather_ps(src, ix, 4));
+        for (int t = 1; t < k; ++t) {
+            ix = _mm256_loadu_si256((const __m256i*)(idx + t * n + i));
+            v = _mm256_add_ps(v, _mm256_mul_ps(_mm256_loadu_ps(w + t * n + i),
+                                               _mm256_i32gather_ps(src, ix, 4)));
+        }
+        _mm256_storeu_ps(dst + i, v);
+    }
+    return i;
+}
+#endif
+
+#if defined(DVS_SIMD_NEON)
+static size_t weightedSumNEON(const float* const* rows, const float* w, int k,
+                              size_t n, float* dst) {
+    size_t x = 0;
+    for (; x + 4 <= n; x += 4) {
+        float32x4_t v = vmulq_n_f32(vld1q_f32(rows[0] + x), w[0]);
+        for (int r = 1; r < k; ++r)
+            v = vmlaq_n_f32(v, vld1q_f32(rows[r] + x), w[r]);
+        vst1q_f32(dst + x, v);
+    }
+    return x;
+}
+#endif
+
+void weightedSum(const float* const* rows, const float* w, int k, size_t n, float* dst) {
+    if (k <= 0) return;
+    size_t done = 0;
+    switch (activeIsa()) {
+#if defined(DVS_SIMD_X86)
+        case Isa::AVX2: done = weightedSumAVX2(rows, w, k, n, dst); break;
+#endif
+#if defined(DVS_SIMD_NEON)
+        case Isa::NEON: done = weightedSumNEON(rows, w, k, n, dst); break;
+#endif
+        default: break;
+    }
+    weightedSumScalar(rows, w, k, done, n, dst);
+}
+
+void gatherWeighted(const float* src, const int32_t* idx, const float* w, int k,
+                    size_t n, float* dst) {
+    if (k <= 0) return;
+    size_t done = 0;
+#if defined(DVS_SIMD_X86)
+    if (activeIsa() == Isa::AVX2) done = gatherWeightedAVX2(src, idx, w, k, n, dst);
+#endif
+    // NEON has no gather instruction: scalar loads
+    gatherWeightedScalar(src, idx, w, k, done, n, dst);
+}
+
+// ---- flowColor ----
+// atan2 minimax polynomial, then HSV -> RGB at S = 1 as
+//   c = v - v * clamp(min(k, 4 - k), 0, 1),  k = (offset + hue / 60) mod 6
+// with offsets 5 / 3 / 1 for R / G / B.  Every path evaluates the same
+// operations in the same order.
+static constexpr float kAt0 = -0.0464964749f, kAt1 = 0.15931422f, kAt2 = -0.327622764f;
+static constexpr float kHalfPi = 1.57079637f, kPi = 3.14159274f;
+static constexpr float kRadToSextant = (180.0f / 3.14159265f) / 60.0f;
+static constexpr float kMinMag2 = 0.25f;          // |v| < 0.5 px/s stays black
+static constexpr float kHueOffset[3] = {5.f, 3.f, 1.f};
+
+static inline void flowColorScalar(float* fx, float* fy, size_t b, size_t n, float decay,
+                                   float inv_max, uint8_t* rgb) {
+    for (size_t i = b; i < n; ++i) {
+        const float vx = fx[i], vy = fy[i];
+        fx[i] = vx * decay;
+        fy[i] = vy * decay;
+        const float mag2 = vx * vx + vy * vy;
+        float val = std::min(std::sqrt(mag2) * inv_max, 1.0f) * 255.0f;
+        if (mag2 < kMinMag2) val = 0.f;
+
+        const float ax = std::abs(vx), ay = std::abs(vy);
+        const float a = std::min(ax, ay) / (std::max(ax, ay) + 1e-20f);
+        const float s = a * a;
+        float r = ((kAt0 * s + kAt1) * s + kAt2) * s * a + a;
+        if (ay > ax) r = kHalfPi - r;
+        if (vx < 0)  r = kPi - r;
+        if (vy < 0)  r = -r;
+        const float h6 = r * kRadToSextant + 3.0f;   // hue / 60 in [0, 6]
+
+        uint8_t* px = rgb + i * 3;
+        for (int c = 0; c < 3; ++c) {
+            float k = kHueOffset[c] + h6;
+            if (k >= 6.f) k -= 6.f;
+            const float t = std::min(std::max(std::min(k, 4.f - k), 0.f), 1.f);
+            px[c] = (uint8_t)(val - val * t);
+        }
+    }
+}
+
+#if defined(DVS_SIMD_X86)
+DVS_TARGET_AVX2
+static size_t flowColorAVX2(float* fx, float* fy, size_t n, float decay, float inv_max,
+                            uint8_t* rgb) {
+    const __m256 vdecay = _mm256_set1_ps(decay), vinv = _mm256_set1_ps(inv_max);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.f);
+    const __m256 four = _mm256_set1_ps(4.f), six = _mm256_set1_ps(6.f);
+    const __m256 sign = _mm256_set1_ps(-0.f);
+    // Per 128-bit lane: 4 pixels of 0x00BBGGRR -> 12 packed bytes
+    const __m256i pack = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                          0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    size_t i = 0;
+    // Each lane stores 16 bytes for 12: keep two pixels of slack before n
+    for (; i + 10 <= n; i += 8) {
+        const __m256 vx = _mm256_loadu_ps(fx + i), vy = _mm256_loadu_ps(fy + i);
+        _mm256_storeu_ps(fx + i, _mm256_mul_ps(vx, vdecay));
+        _mm256_storeu_ps(fy + i, _mm256_mul_ps(vy, vdecay));
+        const __m256 mag2 = _mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy));
+        __m256 val = _mm256_mul_ps(_mm256_min_ps(_mm256_mul_ps(_mm256_sqrt_ps(mag2), vinv), one),
+                                   _mm256_set1_ps(255.f));
+        val = _mm256_and_ps(val, _mm256_cmp_ps(mag2, _mm256_set1_ps(kMinMag2), _CMP_GE_OQ));
+
+        const __m256 ax = _mm256_andnot_ps(sign, vx), ay = _mm256_andnot_ps(sign, vy);
+        const __m256 a = _mm256_div_ps(_mm256_min_ps(ax, ay),
+                                       _mm256_add_ps(_mm256_max_ps(ax, ay), _mm256_set1_ps(1e-20f)));
+        const __m256 s = _mm256_mul_ps(a, a);
+        __m256 p = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(kAt0), s), _mm256_set1_ps(kAt1));
+        p = _mm256_add_ps(_mm256_mul_ps(p, s), _mm256_set1_ps(kAt2));
+        __m256 r = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(p, s), a), a);
+        r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(kHalfPi), r), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+        r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(kPi), r), _mm256_cmp_ps(vx, zero, _CMP_LT_OQ));
+        r = _mm256_blendv_ps(r, _mm256_xor_ps(r, sign), _mm256_cmp_ps(vy, zero, _CMP_LT_OQ));
+        const __m256 h6 = _mm256_add_ps(_mm256_mul_ps(r, _mm256_set1_ps(kRadToSextant)), _mm256_set1_ps(3.f));
+
+        __m256i ch[3];
+        for (int c = 0; c < 3; ++c) {
+            __m256 k = _mm256_add_ps(_mm256_set1_ps(kHueOffset[c]), h6);
+            k = _mm256_blendv_ps(k, _mm256_sub_ps(k, six), _mm256_cmp_ps(k, six, _CMP_GE_OQ));
+            const __m256 t = _mm256_min_ps(_mm256_max_ps(_mm256_min_ps(k, _mm256_sub_ps(four, k)), zero), one);
+            ch[c] = _mm256_cvttps_epi32(_mm256_sub_ps(val, _mm256_mul_ps(val, t)));
+        }
+        __m256i px = _mm256_or_si256(ch[0], _mm256_or_si256(_mm256_slli_epi32(ch[1], 8),
+                                                             _mm256_slli_epi32(ch[2], 16)));
+        px = _mm256_shuffle_epi8(px, pack);
+        _mm_storeu_si128((__m128i*)(rgb + i * 3), _mm256_castsi256_si128(px));
+        _mm_storeu_si128((__m128i*)(rgb + i * 3 + 12), _mm256_extracti128_si256(px, 1));
+    }
+    return i;
+}
+#endif
+
+#if defined(DVS_SIMD_NEON)
+static size_t flowColorNEON(float* fx, float* fy, size_t n, float decay, float inv_max,
+                            uint8_t* rgb) {
+    const float32x4_t vdecay = vdupq_n_f32(decay), vinv = vdupq_n_f32(inv_max);
+    const float32x4_t zero = vdupq_n_f32(0.f), one = vdupq_n_f32(1.f);
+    const float32x4_t four = vdupq_n_f32(4.f), six = vdupq_n_f32(6.f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint16x4_t c16[3][2];
+        for (int half = 0; half < 2; ++half) {
+            const size_t j = i + 4 * half;
+            const float32x4_t vx = vld1q_f32(fx + j), vy = vld1q_f32(fy + j);
+            vst1q_f32(fx + j, vmulq_f32(vx, vdecay));
+            vst1q_f32(fy + j, vmulq_f32(vy, vdecay));
+            const float32x4_t mag2 = vaddq_f32(vmulq_f32(vx, vx), vmulq_f32(vy, vy));
+            float32x4_t val = vmulq_f32(vminq_f32(vmulq_f32(vsqrtq_f32(mag2), vinv), one),
+                                        vdupq_n_f32(255.f));
+            val = vbslq_f32(vcgeq_f32(mag2, vdupq_n_f32(kMinMag2)), val, zero);
+
+            const float32x4_t ax = vabsq_f32(vx), ay = vabsq_f32(vy);
+            const float32x4_t a = vdivq_f32(vminq_f32(ax, ay),
+                                            vaddq_f32(vmaxq_f32(ax, ay), vdupq_n_f32(1e-20f)));
+            const float32x4_t s = vmulq_f32(a, a);
+            float32x4_t p = vaddq_f32(vmulq_f32(vdupq_n_f32(kAt0), s), vdupq_n_f32(kAt1));
+            p = vaddq_f32(vmulq_f32(p, s), vdupq_n_f32(kAt2));
+            float32x4_t r = vaddq_f32(vmulq_f32(vmulq_f32(p, s), a), a);
+            r = vbslq_f32(vcgtq_f32(ay, ax), vsubq_f32(vdupq_n_f32(kHalfPi), r), r);
+            r = vbslq_f32(vcltq_f32(vx, zero), vsubq_f32(vdupq_n_f32(kPi), r), r);
+            r = vbslq_f32(vcltq_f32(vy, zero), vnegq_f32(r), r);
+            const float32x4_t h6 = vaddq_f32(vmulq_f32(r, vdupq_n_f32(kRadToSextant)), vdupq_n_f32(3.f));
+
+            for (int c = 0; c < 3; ++c) {
+                float32x4_t k = vaddq_f32(vdupq_n_f32(kHueOffset[c]), h6);
+                k = vbslq_f32(vcgeq_f32(k, six), vsubq_f32(k, six), k);
+                const float32x4_t t = vminq_f32(vmaxq_f32(vminq_f32(k, vsubq_f32(four, k)), zero), one);
+                c16[c][half] = vmovn_u32(vcvtq_u32_f32(vsubq_f32(val, vmulq_f32(val, t))));
+            }
+        }
+        uint8x8x3_t px;
+        for (int c = 0; c < 3; ++c) px.val[c] = vmovn_u16(vcombine_u16(c16[c][0], c16[c][1]));
+        vst3_u8(rgb + i * 3, px);
+    }
+    return i;
+}
+#endif
+
+void flowColor(float* fx, float* fy, size_t n, float decay, float inv_max, uint8_t* rgb) {
+    size_t done = 0;
+    switch (activeIsa()) {
+#if defined(DVS_SIMD_X86)
+        case Isa::AVX2: done = flowColorAVX2(fx, fy, n, decay, inv_max, rgb); break;
+#endif
+#if defined(DVS_SIMD_NEON)
+        case Isa::NEON: done = flowColorNEON(fx, fy, n, decay, inv_max, rgb); break;
+#endif
+        default: break;
+    }
+    flowColorScalar(fx, fy, done, n, decay, inv_max, rgb);
+}
+
+// ---- benchmarkVTEI ----
+namespace {
+
+// Dense-channel path as it was before the kernels: std::exp per pixel, a
+// grayscale pass, then a Sobel pass with a clamped accessor.
+void referenceVTEI(const float* ts, const uint8_t* rgb, int W, int H, float latest,
+                   float tau, std::vector<uint8_t>& gray, float* T, float* E, float* I) {
+    const size_t n = (size_t)W * H;
+    for (size_t i = 0; i < n; ++i) {
+        float dt = std::max(0.f, latest - ts[i]);
+        T[i] = std::clamp(std::exp(-dt / tau), 0.f, 1.f);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t* p = rgb + i * 3;
+        gray[i] = (uint8_t)(kWr * p[0] + kWg * p[1] + kWb * p[2]);
+    }
+    auto at = [&](int x, int y) -> int {
+        x = std::clamp(x, 0, W - 1);
+        y = std::clamp(y, 0, H - 1);
+        return gray[(size_t)y * W + x];
+    };
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            float e = 0.f;
+            if (x > 0 && y > 0 && x < W - 1 && y < H - 1) {
+                int gx = at(x+1,y-1) + 2*at(x+1,y) + at(x+1,y+1) - at(x-1,y-1) - 2*at(x-1,y) - at(x-1,y+1);
+                int gy = at(x-1,y+1) + 2*at(x,y+1) + at(x+1,y+1) - at(x-1,y-1) - 2*at(x,y-1) - at(x+1,y-1);
+                e = std::min(1.f, std::sqrt(float(gx*gx + gy*gy)) / (4.f * 255.f));
+            }
+            E[(size_t)y * W + x] = e;
+            I[(size_t)y * W + x] = gray[(size_t)y * W + x] / 255.f;
+        }
+    }
+}
+
+} // namespace
+
+void benchmarkVTEI() {
+    using clk = std::chrono::steady_clock;
+    const float tau = 5e5f;
+    const int reps = 50;
+    const int sizes[2][2] = {{346, 260}, {640, 480}};
+
+    ofLogNotice() << "[VTEI bench] detected ISA: " << isaName(detectedIsa());
+
+    for (auto& sz : sizes) {
+        const int W = sz[0], H = sz[1];
+        const size_t n = (size_t)W * H;
+
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> px(0, 255);
+        std::uniform_real_distribution<float> age(0.f, 4e6f);
+        std::vector<uint8_t> rgb(n * 3);
+        for (auto& v : rgb) v = (uint8_t)px(rng);
+        const float latest = 1e7f;
+        std::vector<float> ts(n);
+        for (auto& t : ts) t = latest - age(rng);
+
+        std::vector<uint8_t> gray(n);
+        std::vector<float> T0(n), E0(n), I0(n), T1(n), E1(n), I1(n);
+        DecayLUT lut;
+        lut.build(tau);
+
+        auto t0 = clk::now();
+        for (int r = 0; r < reps; ++r)
+            referenceVTEI(ts.data(), rgb.data(), W, H, latest, tau, gray, T0.data(), E0.data(), I0.data());
+        auto t1 = clk::now();
+
+        auto runKernels = [&] {
+            for (int r = 0; r < reps; ++r) {
+                timeSurface(ts.data(), n, latest, lut, T1.data());
+                grayEdgeIntensity(rgb.data(), 3, W, H, gray.data(), E1.data(), I1.data());
+            }
+        };
+        const bool wasForced = g_force_scalar.load();
+        forceScalar(true);
+        auto t2 = clk::now();
+        runKernels();
+        auto t3 = clk::now();
+        forceScalar(wasForced);
+        runKernels();
+        auto t4 = clk::now();
+
+        float dT = 0.f, dE = 0.f, dI = 0.f;
+        for (size_t i = 0; i < n; ++i) {
+            dT = std::max(dT, std::abs(T0[i] - T1[i]));
+            dE = std::max(dE, std::abs(E0[i] - E1[i]));
+            dI = std::max(dI, std::abs(I0[i] - I1[i]));
+        }
+
+        auto ms = [&](clk::time_point a, clk::time_point b) {
+            return std::chrono::duration<double, std::milli>(b - a).count() / reps;
+        };
+        ofLogNotice() << "[VTEI bench] " << W << "x" << H
+                      << "  reference " << ms(t0, t1) << " ms"
+                      << "  kernels/scalar " << ms(t2, t3) << " ms"
+                      << "  kernels/" << isaName(activeIsa()) << " " << ms(t3, t4) << " ms"
+                      << "  max|dT| " << dT << " max|dE| " << dE << " max|dI| " << dI;
+    }
+}
+
+} // namespace simd
+} // namespace dvs
@@ -0,0 +1,97 @@
+#pragma once
+/// @file dvs_simd.hpp
+/// @brief Vectorized kernels for the dense VTEI channels and FP16 conversion
+///        (AVX2 / F16C / NEON / scalar).
+///
+/// The instruction set is picked once at runtime: AVX2 kernels are compiled
+/// with a function-level target attribute and only used when the CPU reports
+/// support, NEON is used unconditionally on aarch64, everything else falls
+/// back to scalar loops that produce the same values.
+///
+/// All kernels work on the sensor grid (row-major W x H); the YOLO pipeline
+/// then gathers the planes to model resolution.
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace dvs {
+namespace simd {
+
+enum class Isa { Scalar = 0, AVX2 = 1, NEON = 2 };
+
+/// Best instruction set available on this CPU (cached after the first call).
+Isa detectedIsa();
+
+/// Instruction set the kernels currently dispatch to.
+Isa activeIsa();
+
+/// Force the scalar path (benchmarking / debugging).
+void forceScalar(bool on);
+
+const char* isaName(Isa isa);
+
+/// exp(-dt / tau) sampled at a fixed step; entries past the table are 0.
+struct DecayLUT {
+    float tau_us   = 0.f;
+    float inv_step = 0.f;          ///< table entries per microsecond
+    std::vector<float> table;
+
+    /// Rebuild for a new time constant (no-op if unchanged).
+    /// @param span_taus  table covers dt in [0, span_taus * tau)
+    void build(float tau_us, int entries = 4096, float span_taus = 8.f);
+};
+
+/// Time-surface channel: out[i] = exp(-max(0, latest - last_ts[i]) / tau)
+/// via the LUT.
+void timeSurface(const float* last_ts, size_t n, float latest_ts,
+                 const DecayLUT& lut, float* out);
+
+/// Fused grayscale + Sobel + intensity pass over an interleaved 8-bit image
+/// with `nc` channels.  Grayscale rows are converted one row ahead of the
+/// Sobel row into `gray` (W*H scratch), so the image is traversed once.
+///   edge[i]      = min(1, |sobel| / (4*255)), 0 on the border
+///   intensity[i] = gray / 255
+void grayEdgeIntensity(const uint8_t* src, int nc, int W, int H,
+                       uint8_t* gray, float* edge, float* intensity);
+
+/// Column-wise max over a row-major [rows, n] matrix (e.g. per-anchor class
+/// logits of a [C, N] YOLO head): max_out[i] = max_r src[r*n + i] and
+/// arg_out[i] = the first r attaining it.
+void columnMaxArg(const float* src, int rows, size_t n, float* max_out, int32_t* arg_out);
+
+/// Resampling rows (nn::ResamplePlan):
+/// weightedSum:    dst[x] = sum_r w[r] * rows[r][x]            (x < n)
+/// gatherWeighted: dst[i] = sum_t w[t*n + i] * src[idx[t*n + i]] (i < n)
+/// i.e. k taps stored tap-major.
+void weightedSum(const float* const* rows, const float* w, int k, size_t n, float* dst);
+void gatherWeighted(const float* src, const int32_t* idx, const float* w, int k,
+                    size_t n, float* dst);
+
+/// Optical-flow colour pass over n pixels of the (fx, fy) velocity maps:
+/// hue from the direction (atan2 polynomial, max error ~1e-5 rad), value
+/// min(1, |v| * inv_max_speed) * 255, black below 0.5 px/s.  Writes
+/// interleaved RGB bytes and decays fx / fy in place by `decay`.  Paths
+/// agree bit for bit unless the scalar loop is built with FMA contraction
+/// (then within one count).
+void flowColor(float* fx, float* fy, size_t n, float decay, float inv_max_speed,
+               uint8_t* rgb);
+
+/// IEEE binary16 conversion (F16C on x86, NEON on aarch64, scalar fallback;
+/// picked at runtime).  All paths round to nearest even and map finite
+/// overflow to +-Inf, so the scalar fallback gives the same bits.
+bool hasF16C();
+void f32ToF16(const float* src, uint16_t* dst, size_t n);
+void f16ToF32(const uint16_t* src, float* dst, size_t n);
+
+/// Time float<->half conversion of a 5x288x352 tensor, scalar vs. the
+/// runtime-selected path, and log cost and maximum deviation.
+void benchmarkF16();
+
+/// Time the VTEI dense channels (std::exp time surface, separate grayscale
+/// and Sobel passes) against the SIMD kernels at 346x260 and 640x480 and
+/// log per-frame cost and maximum deviation.
+void benchmarkVTEI();
+
+} // namespace simd
+} // namespace dvs
@@ -0,0 +1,117 @@
+#pragma once
+/// @file dvs_thread_pool.hpp
+/// @brief Small persistent thread pool for data-parallel loops on the main thread.
+///
+/// parallelFor() splits [0, n) into chunks that worker threads and the
+/// calling thread pull from a shared atomic counter, then blocks until every
+/// chunk is done.  Intended for per-event / per-row work inside
+/// ofxDVS::update(); call it from one thread at a time.  The body must not
+/// throw.
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+namespace dvs {
+
+class ThreadPool {
+public:
+    using RangeFn = std::function<void(size_t begin, size_t end)>;
+
+    /// @param num_workers  extra threads besides the caller (0 = hardware/2 - 1)
+    explicit ThreadPool(unsigned num_workers = 0) {
+        if (num_workers == 0) {
+            unsigned hw = std::max(2u, std::thread::hardware_concurrency());
+            num_workers = std::max(1u, hw / 2) - 1;
+        }
+        for (unsigned i = 0; i < num_workers; ++i)
+            workers_.emplace_back(&ThreadPool::loop_, this);
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : workers_)
+            if (t.joinable()) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Number of threads that execute chunks (workers + caller).
+    size_t size() const { return workers_.size() + 1; }
+
+    /// Run fn(begin, end) over [0, n) in chunks of at least `grain` items.
+    void parallelFor(size_t n, size_t grain, const RangeFn& fn) {
+        if (n == 0) return;
+        grain = std::max<size_t>(1, grain);
+        if (workers_.empty() || n <= grain) {
+            fn(0, n);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            job_ = &fn;
+            n_ = n;
+            grain_ = grain;
+            next_ = 0;
+            pending_ = workers_.size();
+            ++generation_;
+        }
+        cv_.notify_all();
+
+        runChunks_();
+
+        std::unique_lock<std::mutex> lk(mu_);
+        done_cv_.wait(lk, [&] { return pending_ == 0; });
+        job_ = nullptr;
+    }
+
+private:
+    void runChunks_() {
+        while (true) {
+            size_t b = next_.fetch_add(grain_);
+            if (b >= n_) break;
+            (*job_)(b, std::min(n_, b + grain_));
+        }
+    }
+
+    void loop_() {
+        size_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lk(mu_);
+                cv_.wait(lk, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+            }
+            runChunks_();
+            {
+                std::lock_guard<std::mutex> lk(mu_);
+                if (--pending_ == 0) done_cv_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::condition_variable done_cv_;
+
+    const RangeFn* job_ = nullptr;
+    size_t n_ = 0;
+    size_t grain_ = 1;
+    std::atomic<size_t> next_{0};
+    size_t pending_ = 0;
+    size_t generation_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace dvs
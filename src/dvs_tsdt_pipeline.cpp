@@ -1,7 +1,6 @@
 #include "dvs_tsdt_pipeline.hpp"
 #include "ofxDVS.hpp" // for struct polarity
 
-#include <opencv2/imgproc.hpp>
 #include <algorithm>
 #include <cmath>
 #include <sstream>
@@ -14,23 +13,71 @@
 namespace dvs {
 
 // ---- loadModel ----
-void TsdtPipeline::loadModel(const std::string& path, int threads) {
+OnnxRunner::Config TsdtPipeline::runnerConfig_(const std::string& path, int threads) {
     OnnxRunner::Config scfg;
     scfg.model_path = path;
-    if (threads > 0) scfg.intra_op_num_threads = threads;
+    scfg.thread_budget = threads;
     scfg.normalize_01 = false;  // we feed already-prepared [0,1] binary maps
     scfg.verbose = false;
+    return scfg;
+}
+
+void TsdtPipeline::loadModel(const std::string& path, int threads) {
+    auto runner = std::make_unique<OnnxRunner>(runnerConfig_(path, threads));
+    runner->load();
+    std::lock_guard<std::mutex> lk(run_mu_);
+    install_(std::move(runner));
+}
+
+bool TsdtPipeline::loadModelAsync(const std::string& path, int threads) {
+    if (pending_ || !loader_.start(runnerConfig_(path, threads))) {
+        ofLogWarning() << "[" << cfg.log_tag << "] a model load is already in progress";
+        return false;
+    }
+    ofLogNotice() << "[" << cfg.log_tag << "] loading " << path << " in the background";
+    return true;
+}
+
+bool TsdtPipeline::pollLoad() {
+    if (!pending_) {
+        if (!loader_.busy()) return false;
+        pending_ = loader_.take();
+        if (!pending_) {
+            if (!loader_.busy())
+                ofLogError() << "[" << cfg.log_tag << "] failed to load " << loader_.path()
+                             << ": " << loader_.error();
+            return false;
+        }
+        swap_pending_ = true;
+    }
+    std::unique_lock<std::mutex> lk(run_mu_, std::try_to_lock);
+    if (!lk.owns_lock()) return false;
+    install_(std::move(pending_));
+    swap_pending_ = false;
+    return true;
+}
+
+LoadState TsdtPipeline::loadState() const {
+    if (loader_.busy() || pending_) return LoadState::Loading;
+    if (isLoaded()) return LoadState::Ready;
+    return loader_.error().empty() ? LoadState::Empty : LoadState::Failed;
+}
 
-    tsdt_ = std::make_unique<OnnxRunner>(scfg);
-    tsdt_->load();
+void TsdtPipeline::install_(std::unique_ptr<OnnxRunner> runner) {
+    tsdt_ = std::move(runner);
+    model_path_ = tsdt_->config().model_path;
 
     cached_sW_ = 0;
     cached_sH_ = 0;
+    bound_T_ = bound_H_ = bound_W_ = 0;   // new session: rebind on first run
+    ema_logits_.clear();
 
     // Auto-detect stateful SNN model (has "state_in" input)
     stateful_ = false;
     state_size_ = 0;
-    snn_state_.clear();
+    snn_state_[0].clear();
+    snn_state_[1].clear();
+    state_cur_ = 0;
     for (const auto& inp : tsdt_->inputs()) {
         if (inp.name == "state_in") {
             stateful_ = true;
@@ -40,13 +87,14 @@ void TsdtPipeline::loadModel(const std::string& path, int threads) {
                 if (d > 0) sz *= d;
             }
             state_size_ = (int)sz;
-            snn_state_.assign(state_size_, 0.f);
+            snn_state_[0].assign(state_size_, 0.f);
+            snn_state_[1].assign(state_size_, 0.f);
             ofLogNotice() << "[" << cfg.log_tag << "] stateful SNN model (state_size=" << state_size_ << ")";
             break;
         }
     }
 
-    ofLogNotice() << "[TsdtPipeline] loaded " << path;
+    ofLogNotice() << "[TsdtPipeline] loaded " << tsdt_->loadedPath();
 }
 
 // ---- ensureLetterboxParams_ ----
@@ -73,7 +121,7 @@ void TsdtPipeline::pushEvents(const std::vector<polarity>& events,
         if (cfg.time_based_binning && !hist_.empty() &&
             p.timestamp < hist_.back().ts - 1000000) {
             hist_.clear();
-            ema_logits_.clear();
+            reset_state_ = true;
         }
 
         hist_.push_back({x, y, (bool)p.pol, p.timestamp});
@@ -144,13 +192,11 @@ std::vector<float> TsdtPipeline::buildTensor(int sensorW, int sensorH) {
             }
         }
 
-        // Anti-aliased resize each channel from sensor res to model input res
+        // Anti-aliased resize of both channels from sensor res to model input
+        // res (stretched, area weights cached per geometry)
         tsdt_tensor_.resize(2 * plane);
-        for (int c = 0; c < 2; ++c) {
-            cv::Mat src(sensorH, sensorW, CV_32FC1, sensor_buf_.data() + c * sensorPlane);
-            cv::Mat dst(Hd, Wd, CV_32FC1, tsdt_tensor_.data() + c * plane);
-            cv::resize(src, dst, cv::Size(Wd, Hd), 0, 0, cv::INTER_AREA);
-        }
+        resize_plan_.ensure(sensorW, sensorH, Wd, Hd, cfg.resample, false);
+        resize_plan_.run(sensor_buf_.data(), tsdt_tensor_.data(), 2);
 
         return tsdt_tensor_;
     }
@@ -222,58 +268,68 @@ std::vector<float> TsdtPipeline::buildTensor(int sensorW, int sensorH) {
     return tsdt_tensor_;
 }
 
-// ---- infer ----
-std::pair<int, float> TsdtPipeline::infer(int sensorW, int sensorH) {
-    if (!tsdt_ || !tsdt_->isLoaded()) return {-1, 0.f};
+// ---- prepare ----
+bool TsdtPipeline::prepare(int sensorW, int sensorH, TsdtInput& out) {
+    if (!tsdt_ || !tsdt_->isLoaded()) return false;
 
     if (cfg.time_based_binning) {
         // Rate-limit: don't run more often than the window period
-        if (last_predict_time_ > 0.f) {
-            float elapsed = ofGetElapsedTimef() - last_predict_time_;
-            if (elapsed < cfg.bin_window_ms / 1000.f) return {last_idx_, last_conf_};
+        if (last_submit_time_ > 0.f) {
+            float elapsed = ofGetElapsedTimef() - last_submit_time_;
+            if (elapsed < cfg.bin_window_ms / 1000.f) return false;
         }
         // Time-based readiness: need events spanning at least one window
-        if (hist_.empty()) return {-1, 0.f};
+        if (hist_.empty()) return false;
         float winUs = cfg.bin_window_ms * 1000.f;
         long span = hist_.back().ts - hist_.front().ts;
-        if (span < (long)winUs) return {-1, 0.f};
+        if (span < (long)winUs) return false;
     } else {
         const size_t need = (size_t)cfg.T * (size_t)cfg.ev_per_bin;
-        if (hist_.size() < need) return {-1, 0.f};
+        if (hist_.size() < need) return false;
     }
 
-    auto tensor = buildTensor(sensorW, sensorH);
-    if (tensor.empty()) return {-1, 0.f};
+    out.tensor = buildTensor(sensorW, sensorH);
+    if (out.tensor.empty()) return false;
+    out.epoch = epoch_;
+    last_submit_time_ = ofGetElapsedTimef();
+
+    ofLogVerbose() << "[" << cfg.log_tag << "] prepared tensor, hist=" << hist_.size();
 
+    // Consume the events we used
+    if (cfg.time_based_binning) {
+        // Erase events older than the consumed window
+        float winUs = cfg.bin_window_ms * 1000.f;
+        long totalSpan = (long)(cfg.T * winUs);
+        long cutoff = hist_.back().ts - totalSpan;
+        while (!hist_.empty() && hist_.front().ts < cutoff)
+            hist_.pop_front();
+    } else {
+        const size_t need = (size_t)cfg.T * (size_t)cfg.ev_per_bin;
+        hist_.erase(hist_.begin(), hist_.begin() + (std::ptrdiff_t)need);
+    }
+    return true;
+}
+
+// ---- runTensor (worker thread) ----
+TsdtResult TsdtPipeline::runTensor(const TsdtInput& in) {
+    TsdtResult res;
+    res.epoch = in.epoch;
+    // A new model is waiting to be swapped in: no prediction this step
+    if (swap_pending_) return res;
+    std::lock_guard<std::mutex> lk(run_mu_);
+    if (!tsdt_ || !tsdt_->isLoaded() || in.tensor.empty()) return res;
+
+    // History was cleared on the main thread: drop EMA and membrane state
+    if (reset_state_.exchange(false)) {
+        ema_logits_.clear();
+        std::fill(snn_state_[state_cur_].begin(), snn_state_[state_cur_].end(), 0.f);
+    }
+
+    const auto& tensor = in.tensor;
     try {
-        std::map<std::string, std::vector<float>> outmap;
-
-        if (stateful_) {
-            // Stateful SNN: shape [1, 2, H, W], pass state_in alongside
-            std::vector<int64_t> frame_shape = {1, 2, (int64_t)cfg.inH, (int64_t)cfg.inW};
-            std::vector<int64_t> state_shape = {1, (int64_t)state_size_};
-            std::vector<std::pair<const float*, std::vector<int64_t>>> inputs = {
-                {tensor.data(), frame_shape},
-                {snn_state_.data(), state_shape}
-            };
-            outmap = tsdt_->runRawMulti(inputs);
-
-            // Update SNN membrane state from output
-            auto sit = outmap.find("state_out");
-            if (sit != outmap.end()) {
-                snn_state_ = sit->second;
-            }
-        } else {
-            // Non-stateful: shape [1, T, 2, H, W]
-            std::vector<int64_t> shape = {1, (int64_t)cfg.T, 2, cfg.inH, cfg.inW};
-            outmap = tsdt_->runRaw(tensor.data(), shape);
-        }
+        if (!runStep_(tensor)) return res;
 
-        // Pick logits
-        const std::vector<float>* pv = nullptr;
-        auto it = outmap.find("logits");
-        pv = (it != outmap.end()) ? &it->second : &outmap.begin()->second;
-        const auto& logits = *pv;
+        const auto& logits = tsdt_->boundOutput(logits_idx_);
 
         // EMA smoothing (skipped when ema_alpha == 1.0; SNN state handles temporal integration)
         if (ema_logits_.size() != logits.size())
@@ -282,23 +338,7 @@ std::pair<int, float> TsdtPipeline::infer(int sensorW, int sensorH) {
             ema_logits_[i] = cfg.ema_alpha * logits[i]
                            + (1.f - cfg.ema_alpha) * ema_logits_[i];
 
-        // Softmax
-        float maxv = *std::max_element(ema_logits_.begin(), ema_logits_.end());
-        softmax_exps_.resize(ema_logits_.size());
-        float sum = 0.f;
-        for (size_t i = 0; i < softmax_exps_.size(); ++i) {
-            softmax_exps_[i] = std::exp(ema_logits_[i] - maxv);
-            sum += softmax_exps_[i];
-        }
-
-        float bestp = 0.f; int besti = -1;
-        for (size_t i = 0; i < softmax_exps_.size(); ++i) {
-            float p = softmax_exps_[i] / sum;
-            if (p > bestp) { bestp = p; besti = (int)i; }
-        }
-        last_idx_  = besti;
-        last_conf_ = bestp;
-        last_predict_time_ = ofGetElapsedTimef();
+        softmaxArgmax_(ema_logits_.data(), ema_logits_.size(), res);
 
         // Tensor diagnostics + logits (verbose, rate-limited by inference rate)
         {
@@ -311,32 +351,177 @@ std::pair<int, float> TsdtPipeline::infer(int sensorW, int sensorH) {
                 oss << logits[i];
             }
             ofLogVerbose() << "[" << cfg.log_tag << "] tensor: sum=" << tsum
-                           << " nonzero=" << tnz << "/" << tensor.size()
-                           << " hist=" << hist_.size();
+                           << " nonzero=" << tnz << "/" << tensor.size();
             ofLogVerbose() << "[" << cfg.log_tag << "] logits: " << oss.str();
-            ofLogNotice()  << "[" << cfg.log_tag << "] argmax=" << last_idx_
-                           << " conf=" << last_conf_;
+            ofLogNotice()  << "[" << cfg.log_tag << "] argmax=" << res.idx
+                           << " conf=" << res.conf;
         }
 
-        // Consume the events we used
-        if (cfg.time_based_binning) {
-            // Erase events older than the consumed window
-            float winUs = cfg.bin_window_ms * 1000.f;
-            long totalSpan = (long)(cfg.T * winUs);
-            long cutoff = hist_.back().ts - totalSpan;
-            while (!hist_.empty() && hist_.front().ts < cutoff)
-                hist_.pop_front();
-        } else {
-            const size_t need = (size_t)cfg.T * (size_t)cfg.ev_per_bin;
-            hist_.erase(hist_.begin(), hist_.begin() + (std::ptrdiff_t)need);
+    } catch (const std::exception& e) {
+        ofLogError() << "[" << cfg.log_tag << "] inference error: " << e.what();
+        res.idx = -1;
+        res.conf = 0.f;
+    }
+
+    return res;
+}
+
+// ---- runStep_ (worker thread, run_mu_ held) ----
+bool TsdtPipeline::runStep_(const std::vector<float>& tensor) {
+    ensureBinding_();
+    const size_t plane = (size_t)cfg.inH * cfg.inW;
+    const size_t need  = stateful_ ? 2 * plane : (size_t)cfg.T * 2 * plane;
+    if (tensor.size() != need) {
+        ofLogWarning() << "[" << cfg.log_tag << "] tensor size " << tensor.size()
+                       << " != " << need << " (config changed?), skipped";
+        return false;
+    }
+
+    if (stateful_) {
+        // Stateful SNN: [1, 2, H, W] frame plus state_in [1, S]
+        std::vector<float>& s_in  = snn_state_[state_cur_];
+        std::vector<float>& s_out = snn_state_[state_cur_ ^ 1];
+        if (state_pingpong_)
+            tsdt_->bindOutputTo(state_out_idx_, s_out.data(), {1, (int64_t)state_size_});
+        tsdt_->runBound({tensor.data(), s_in.data()});
+
+        // Advance the membrane state
+        if (state_pingpong_) {
+            state_cur_ ^= 1;
+        } else if (state_out_idx_ >= 0) {
+            const auto& so = tsdt_->boundOutput(state_out_idx_);
+            if (so.size() == s_in.size())
+                std::copy(so.begin(), so.end(), s_in.begin());
+        }
+    } else {
+        // Non-stateful: shape [1, T, 2, H, W]
+        tsdt_->runBound({tensor.data()});
+    }
+    return true;
+}
+
+// ---- softmaxArgmax_ ----
+void TsdtPipeline::softmaxArgmax_(const float* logits, size_t n, TsdtResult& res) {
+    if (n == 0) return;
+    float maxv = *std::max_element(logits, logits + n);
+    softmax_exps_.resize(n);
+    float sum = 0.f;
+    for (size_t i = 0; i < n; ++i) {
+        softmax_exps_[i] = std::exp(logits[i] - maxv);
+        sum += softmax_exps_[i];
+    }
+
+    float bestp = 0.f; int besti = -1;
+    for (size_t i = 0; i < n; ++i) {
+        float p = softmax_exps_[i] / sum;
+        if (p > bestp) { bestp = p; besti = (int)i; }
+    }
+    res.idx  = besti;
+    res.conf = bestp;
+}
+
+// ---- runTensorBatch ----
+std::vector<TsdtResult> TsdtPipeline::runTensorBatch(const std::vector<TsdtInput>& ins) {
+    std::vector<TsdtResult> out(ins.size());
+    for (size_t k = 0; k < ins.size(); ++k) out[k].epoch = ins[k].epoch;
+    if (ins.empty() || swap_pending_) return out;
+
+    std::lock_guard<std::mutex> lk(run_mu_);
+    if (!tsdt_ || !tsdt_->isLoaded()) return out;
+
+    // Membrane state must advance one window at a time
+    if (stateful_) {
+        try {
+            for (size_t k = 0; k < ins.size(); ++k) {
+                if (!runStep_(ins[k].tensor)) break;
+                const auto& logits = tsdt_->boundOutput(logits_idx_);
+                softmaxArgmax_(logits.data(), logits.size(), out[k]);
+            }
+        } catch (const std::exception& e) {
+            ofLogError() << "[" << cfg.log_tag << "] batch inference error: " << e.what();
+        }
+        return out;
+    }
+
+    const std::vector<int64_t> item_shape = tensorShape();
+    const size_t need = (size_t)cfg.T * 2 * cfg.inH * cfg.inW;
+    for (const auto& in : ins) {
+        if (in.tensor.size() != need) {
+            ofLogWarning() << "[" << cfg.log_tag << "] batch tensor size " << in.tensor.size()
+                           << " != " << need << " (config changed?), skipped";
+            return out;
+        }
+    }
+
+    try {
+        // Fixed batch-1 export: one bound run per tensor
+        if (!tsdt_->supportsBatch()) {
+            ensureBinding_();
+            for (size_t k = 0; k < ins.size(); ++k) {
+                tsdt_->runBound({ins[k].tensor.data()});
+                const auto& logits = tsdt_->boundOutput(logits_idx_);
+                softmaxArgmax_(logits.data(), logits.size(), out[k]);
+            }
+            return out;
         }
 
+        const size_t B = (size_t)std::max(1, cfg.batch_size);
+        const int li = std::max(0, tsdt_->outputIndex("logits"));
+        const std::string logits_name = tsdt_->outputs()[li].name;
+        std::vector<const void*> items;
+        for (size_t k0 = 0; k0 < ins.size(); k0 += B) {
+            const size_t n = std::min(B, ins.size() - k0);
+            items.clear();
+            for (size_t k = 0; k < n; ++k) items.push_back(ins[k0 + k].tensor.data());
+
+            auto outs = tsdt_->runBatch(items, item_shape);
+            const auto& logits = outs.at(logits_name);
+            const size_t per = logits.size() / n;
+            for (size_t k = 0; k < n; ++k)
+                softmaxArgmax_(logits.data() + k * per, per, out[k0 + k]);
+        }
     } catch (const std::exception& e) {
-        ofLogError() << "[" << cfg.log_tag << "] inference error: " << e.what();
-        return {-1, 0.f};
+        ofLogError() << "[" << cfg.log_tag << "] batch inference error: " << e.what();
     }
+    return out;
+}
+
+// ---- ensureBinding_ (worker thread) ----
+void TsdtPipeline::ensureBinding_() {
+    if (tsdt_->isBound() && bound_T_ == cfg.T && bound_H_ == cfg.inH && bound_W_ == cfg.inW)
+        return;
 
-    return {last_idx_, last_conf_};
+    if (stateful_) {
+        tsdt_->bindIO({{1, 2, (int64_t)cfg.inH, (int64_t)cfg.inW},
+                       {1, (int64_t)state_size_}});
+    } else {
+        tsdt_->bindIO({{1, (int64_t)cfg.T, 2, (int64_t)cfg.inH, (int64_t)cfg.inW}});
+    }
+    bound_T_ = cfg.T;
+    bound_H_ = cfg.inH;
+    bound_W_ = cfg.inW;
+
+    logits_idx_    = std::max(0, tsdt_->outputIndex("logits"));
+    state_out_idx_ = tsdt_->outputIndex("state_out");
+    state_pingpong_ = stateful_ && state_out_idx_ >= 0 &&
+        tsdt_->outputs()[state_out_idx_].type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+}
+
+// ---- applyResult ----
+void TsdtPipeline::applyResult(const TsdtResult& r) {
+    if (r.epoch != epoch_ || r.idx < 0) return;
+    last_idx_  = r.idx;
+    last_conf_ = r.conf;
+    last_predict_time_ = ofGetElapsedTimef();
+}
+
+// ---- infer ----
+std::pair<int, float> TsdtPipeline::infer(int sensorW, int sensorH) {
+    TsdtInput in;
+    if (!prepare(sensorW, sensorH, in)) return {-1, 0.f};
+    TsdtResult r = runTensor(in);
+    applyResult(r);
+    return {r.idx, r.conf};
 }
 
 // ---- drawLabel ----
@@ -404,6 +589,7 @@ void TsdtPipeline::drawLabel() const {
 
 // ---- selfTest ----
 void TsdtPipeline::selfTest() {
+    std::lock_guard<std::mutex> lk(run_mu_);
     if (!tsdt_ || !tsdt_->isLoaded()) {
         ofLogError() << "[TSDT/SELFTEST] model not loaded";
         return;
@@ -443,6 +629,7 @@ void TsdtPipeline::selfTest() {
 
 // ---- debugFromFile ----
 void TsdtPipeline::debugFromFile(const std::string& binPath) {
+    std::lock_guard<std::mutex> lk(run_mu_);
     if (!tsdt_ || !tsdt_->isLoaded()) {
         ofLogError() << "[TSDT/DEBUG] model not loaded";
         return;
@@ -507,8 +694,10 @@ void TsdtPipeline::clearHistory() {
     last_idx_  = -1;
     last_conf_ = 0.f;
     last_predict_time_ = 0.f;
-    ema_logits_.clear();
-    std::fill(snn_state_.begin(), snn_state_.end(), 0.f);
+    last_submit_time_  = 0.f;
+    ++epoch_;
+    reset_state_ = true;
+    gate.reset();
 }
 
 } // namespace dvs
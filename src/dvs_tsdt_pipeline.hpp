@@ -5,16 +5,22 @@
 ///
 /// Owns its OnnxRunner, maintains a rolling event history, builds the
 /// T x 2 x H x W input tensor, runs inference with EMA smoothing, and draws
-/// the predicted gesture label.
+/// the predicted gesture label.  Tensor building (prepare) stays on the main
+/// thread; the ONNX step (runTensor) can run on an InferenceWorker.
 
 #include <vector>
 #include <deque>
 #include <string>
 #include <memory>
 #include <map>
+#include <atomic>
+#include <mutex>
 
 #include "ofMain.h"
 #include "onnx_run.hpp"
+#include "dvs_model_loader.hpp"
+#include "dvs_activity_gate.hpp"
+#include "dvs_nn_utils.hpp"
 
 // Forward-declare the polarity struct
 struct polarity;
@@ -24,6 +30,19 @@ namespace dvs {
 /// Lightweight event struct for the TSDT event history.
 struct TsEvent { int x, y; bool p; long ts; };
 
+/// Tensor snapshot handed from the main thread to the inference worker.
+struct TsdtInput {
+    std::vector<float> tensor;
+    unsigned epoch = 0;          ///< history generation the tensor was built from
+};
+
+/// Prediction produced by runTensor().
+struct TsdtResult {
+    int   idx  = -1;
+    float conf = 0.f;
+    unsigned epoch = 0;
+};
+
 /// Runtime-tunable TSDT configuration.
 struct TsdtConfig {
     int   T          = 8;        ///< Number of temporal bins
@@ -42,6 +61,8 @@ struct TsdtConfig {
     float label_y_offset     = 0.f;   ///< Vertical offset to avoid label overlap with TSDT
 
     bool  stateful           = false;   ///< true = model has state_in/state_out (SNN membrane state)
+    int   batch_size         = 8;       ///< runTensorBatch() chunk: larger = more throughput, more latency
+    nn::ResampleMode resample = nn::ResampleMode::Area; ///< sensor -> model resize (stateful path)
 
     std::string log_tag      = "TSDT"; ///< Log prefix to distinguish pipeline instances
 
@@ -59,13 +80,31 @@ class TsdtPipeline {
 public:
     TsdtPipeline() = default;
 
-    /// Load the ONNX model.  Call once during setup().
+    /// Load the ONNX model synchronously (blocks until ready).
     /// @param path      Absolute path to the .onnx file.
-    /// @param threads   Intra-op thread count (0 = use OnnxRunner default).
+    /// @param threads   Thread budget (0 = shared global ORT pool, N = private pool).
     void loadModel(const std::string& path, int threads = 0);
 
+    /// Start loading a model on a background thread; the current model keeps
+    /// running until pollLoad() swaps the new one in.  cfg (T, inH, inW, ...)
+    /// is read at swap time.
+    /// @return false if a load is already in progress.
+    bool loadModelAsync(const std::string& path, int threads = 0);
+
+    /// Main thread, once per frame: install a finished background load
+    /// without blocking (runTensor() stands aside while a swap is pending).
+    /// @return true when a new model was installed.
+    bool pollLoad();
+
+    LoadState loadState() const;
+    const std::string& loadError() const { return loader_.error(); }
+    const std::string& modelPath() const { return model_path_; }
+
     bool isLoaded() const { return tsdt_ && tsdt_->isLoaded(); }
 
+    /// True for SNN exports carrying membrane state (state_in / state_out).
+    bool isStateful() const { return stateful_; }
+
     /// Append valid events from the current polarity packet to the rolling history.
     void pushEvents(const std::vector<polarity>& events, int sensorW, int sensorH);
 
@@ -74,8 +113,31 @@ public:
     /// Returns empty vector if not enough events yet.
     std::vector<float> buildTensor(int sensorW, int sensorH);
 
-    /// Run inference.  Returns (class_index, confidence) or (-1, 0) on failure.
-    /// Also consumes the used events from the history.
+    /// Main-thread half of an inference step: rate-limit and readiness
+    /// checks, build the tensor, consume the used events from the history.
+    /// @return true if `out` holds a tensor to run.
+    bool prepare(int sensorW, int sensorH, TsdtInput& out);
+
+    /// Worker half: run ONNX on a prepared tensor, update the SNN state and
+    /// EMA, and return the prediction.  Touches no main-thread state; call
+    /// from one thread at a time.
+    TsdtResult runTensor(const TsdtInput& in);
+
+    /// Offline throughput: run several prepared tensors (consecutive windows
+    /// or windows from several streams) as [n, T, 2, H, W] calls of up to
+    /// cfg.batch_size and return one prediction per tensor, in order.  No
+    /// EMA is applied.  Stateful SNN models run one bound window at a time
+    /// (the state is sequential and advances; a pending clearHistory() reset
+    /// is left to runTensor()); fixed batch-1 exports run one bound call per
+    /// tensor.
+    std::vector<TsdtResult> runTensorBatch(const std::vector<TsdtInput>& ins);
+
+    /// Publish a worker result for drawLabel() (main thread).  Results built
+    /// from a history that has since been cleared are ignored.
+    void applyResult(const TsdtResult& r);
+
+    /// Synchronous prepare() + runTensor() + applyResult().
+    /// Returns (class_index, confidence) or (-1, 0) when nothing ran.
     std::pair<int, float> infer(int sensorW, int sensorH);
 
     /// Draw the predicted gesture label at bottom-center of the window.
@@ -87,7 +149,8 @@ public:
     /// Run inference on a saved tensor file for comparison with Python.
     void debugFromFile(const std::string& binPath);
 
-    /// Clear event history and prediction state.
+    /// Clear event history and prediction state.  Worker-side state (EMA,
+    /// SNN membrane) is reset at the start of the next runTensor().
     void clearHistory();
 
     /// Access last prediction.
@@ -97,24 +160,54 @@ public:
     /// Mutable config for GUI binding.
     TsdtConfig cfg;
 
+    /// Activity gate consulted by the caller before prepare() and committed
+    /// when prepare() returns true (main thread); skipped frames keep the
+    /// previous result.
+    ActivityGate gate;
+
     /// Direct access to the underlying OnnxRunner (for self-test / debug).
     OnnxRunner* runner() { return tsdt_.get(); }
 
+    /// Shape of the tensors prepare() builds: [1,2,H,W] for stateful SNN
+    /// models, [1,T,2,H,W] otherwise.
+    std::vector<int64_t> tensorShape() const {
+        if (stateful_) return {1, 2, (int64_t)cfg.inH, (int64_t)cfg.inW};
+        return {1, (int64_t)cfg.T, 2, (int64_t)cfg.inH, (int64_t)cfg.inW};
+    }
+
 private:
     std::unique_ptr<OnnxRunner> tsdt_;
+    std::string model_path_;
+
+    static OnnxRunner::Config runnerConfig_(const std::string& path, int threads);
+
+    /// Adopt a loaded runner: detect SNN state, reset model-dependent state
+    /// (caller holds run_mu_ or no worker is running).
+    void install_(std::unique_ptr<OnnxRunner> runner);
+
+    // Background load / hot swap
+    ModelLoader loader_;
+    std::unique_ptr<OnnxRunner> pending_;    ///< loaded, waiting for the swap
+    std::atomic<bool> swap_pending_{false};  ///< runTensor() stands aside while set
+    std::mutex run_mu_;                      ///< held by runTensor() and the swap
 
     // Rolling event history
     std::deque<TsEvent> hist_;
 
-    // Prediction state
+    // Prediction state (main thread)
     int   last_idx_  = -1;
     float last_conf_ = 0.f;
     float last_predict_time_ = 0.f;
+    float last_submit_time_  = 0.f;
+    unsigned epoch_ = 0;                 ///< bumped by clearHistory()
+
+    // Set by the main thread, consumed by runTensor()
+    std::atomic<bool> reset_state_{false};
 
     // Pre-allocated buffers
     std::vector<float> tsdt_tensor_;
-    std::vector<float> ema_logits_;
-    std::vector<float> softmax_exps_;
+    std::vector<float> ema_logits_;      ///< worker-side
+    std::vector<float> softmax_exps_;    ///< worker-side
 
     // Cached letterbox params
     float lb_scale_ = 1.f;
@@ -123,13 +216,32 @@ private:
 
     void ensureLetterboxParams_(int sensorW, int sensorH);
 
-    // SNN membrane state (stateful models only)
-    std::vector<float> snn_state_;
+    /// Softmax over logits into softmax_exps_; writes argmax and its probability.
+    void softmaxArgmax_(const float* logits, size_t n, TsdtResult& res);
+
+    // IoBinding, (re)built on the worker when T / input size change
+    void ensureBinding_();
+
+    /// One bound run of `tensor` (run_mu_ held), advancing the SNN state;
+    /// logits in boundOutput(logits_idx_).  No EMA, no logging.
+    /// @return false if the tensor does not match the current config.
+    bool runStep_(const std::vector<float>& tensor);
+    int bound_T_ = 0, bound_H_ = 0, bound_W_ = 0;
+    int logits_idx_ = 0;
+    int state_out_idx_ = -1;
+
+    // SNN membrane state (stateful models only, worker-side)
+    // Ping-pong: state_in reads snn_state_[state_cur_], state_out writes the
+    // other buffer, and the roles swap after each step (no state copies).
+    std::vector<float> snn_state_[2];
+    int state_cur_ = 0;
+    bool state_pingpong_ = false;   ///< false: state_out not float32, copy instead
     int state_size_ = 0;
     bool stateful_ = false;
 
     // Accumulate-then-resize buffer (for training-matched preprocessing)
     std::vector<float> sensor_buf_;
+    nn::ResamplePlan   resize_plan_;     ///< sensor -> model resize (stateful path)
 };
 
 } // namespace dvs
@@ -5,19 +5,67 @@
 #include <cmath>
 #include <sstream>
 #include <iomanip>
+#include <chrono>
+#include <limits>
+#include <random>
 
 namespace dvs {
 
 // ---- loadModel ----
-void YoloPipeline::loadModel(const std::string& path, int threads) {
+OnnxRunner::Config YoloPipeline::runnerConfig_(const std::string& path, int threads) {
     OnnxRunner::Config nncfg;
     nncfg.model_path = path;
-    if (threads > 0) nncfg.intra_op_num_threads = threads;
+    nncfg.thread_budget = threads;
     nncfg.normalize_01 = true;
     nncfg.verbose = false;
+    return nncfg;
+}
+
+void YoloPipeline::loadModel(const std::string& path, int threads) {
+    auto runner = std::make_unique<OnnxRunner>(runnerConfig_(path, threads));
+    runner->load();
+    std::lock_guard<std::mutex> lk(run_mu_);
+    install_(std::move(runner));
+}
 
-    nn_ = std::make_unique<OnnxRunner>(nncfg);
-    nn_->load();
+bool YoloPipeline::loadModelAsync(const std::string& path, int threads) {
+    if (pending_ || !loader_.start(runnerConfig_(path, threads))) {
+        ofLogWarning() << "[YoloPipeline] a model load is already in progress";
+        return false;
+    }
+    ofLogNotice() << "[YoloPipeline] loading " << path << " in the background";
+    return true;
+}
+
+bool YoloPipeline::pollLoad() {
+    if (!pending_) {
+        if (!loader_.busy()) return false;
+        pending_ = loader_.take();
+        if (!pending_) {
+            if (!loader_.busy())
+                ofLogError() << "[YoloPipeline] failed to load " << loader_.path()
+                             << ": " << loader_.error();
+            return false;
+        }
+        swap_pending_ = true;
+    }
+    // Swap once the worker is between runs (infer() stands aside meanwhile)
+    std::unique_lock<std::mutex> lk(run_mu_, std::try_to_lock);
+    if (!lk.owns_lock()) return false;
+    install_(std::move(pending_));
+    swap_pending_ = false;
+    return true;
+}
+
+LoadState YoloPipeline::loadState() const {
+    if (loader_.busy() || pending_) return LoadState::Loading;
+    if (isLoaded()) return LoadState::Ready;
+    return loader_.error().empty() ? LoadState::Empty : LoadState::Failed;
+}
+
+void YoloPipeline::install_(std::unique_ptr<OnnxRunner> runner) {
+    nn_ = std::move(runner);
+    model_path_ = nn_->config().model_path;
 
     auto hw = nn_->getInputHW();
     model_H_ = hw.first  > 0 ? hw.first  : 288;
@@ -26,25 +74,48 @@ void YoloPipeline::loadModel(const std::string& path, int threads) {
     cached_sW_ = 0;
     cached_sH_ = 0;
 
-    ofLogNotice() << "[YoloPipeline] loaded " << path
-                  << " model=" << model_W_ << "x" << model_H_;
+    // Persistent input/output binding: infer() runs without tensor allocation
+    nn_->bindIO({{1, 5, (int64_t)model_H_, (int64_t)model_W_}});
+    out_idx_ = std::max(0, nn_->outputIndex("output0"));
+    half_input_ = nn_->inputIsF16(0);
+
+    smooth_hist_.clear();
+    dets_.clear();
+
+    ofLogNotice() << "[YoloPipeline] loaded " << nn_->loadedPath()
+                  << " model=" << model_W_ << "x" << model_H_
+                  << (half_input_ ? " input=float16" : " input=float32");
 }
 
 // ---- ensureLetterboxParams_ ----
 void YoloPipeline::ensureLetterboxParams_(int sW, int sH) {
-    if (sW == cached_sW_ && sH == cached_sH_) return;
-    nn::letterboxParams(sW, sH, model_W_, model_H_, lb_scale_, lb_padx_, lb_pady_);
+    if (sW == cached_sW_ && sH == cached_sH_ && lb_plan_.mode() == cfg.resample) return;
     cached_sW_ = sW;
     cached_sH_ = sH;
+
+    // Sensor -> model resampling, resolved once per geometry
+    lb_plan_.ensure(sW, sH, model_W_, model_H_, cfg.resample);
+    lb_scale_ = lb_plan_.scale();
+    lb_padx_  = lb_plan_.padX();
+    lb_pady_  = lb_plan_.padY();
+
+    // Geometry changed: start from fresh zeroed buffers so padding stays 0
+    const size_t n = (size_t)5 * model_H_ * model_W_;
+    vtei_pool_.reset(0);
+    vtei_pool16_.reset(0);
+    if (half_input_) vtei_pool16_.reset(n);
+    else             vtei_pool_.reset(n);
+    row_buf_.resize((size_t)5 * lb_plan_.outW());
 }
 
-// ---- buildVTEI (single-pass) ----
-std::vector<float> YoloPipeline::buildVTEI(
+// ---- buildVTEI (direct to model resolution) ----
+VteiTensor YoloPipeline::buildVTEI(
     const std::vector<polarity>& events,
-    float** surfaceMapLastTs,
+    const float* surfaceMapLastTs,
     const ofPixels& intensity,
     int sW, int sH)
 {
+    ensureLetterboxParams_(sW, sH);
     const size_t plane = (size_t)sW * sH;
 
     // Resize pre-allocated buffers once
@@ -69,128 +140,129 @@ std::vector<float> YoloPipeline::buildVTEI(
         }
     }
 
-    // Normalize counts
-    const float count_scale = 5.0f;
-    for (size_t i = 0; i < plane; ++i) {
-        pos_buf_[i] = std::min(1.f, pos_buf_[i] / count_scale);
-        neg_buf_[i] = std::min(1.f, neg_buf_[i] / count_scale);
-    }
-
-    // Time surface
-    T_buf_.assign(plane, 0.f);
+    // Dense channels on the sensor grid (vectorized, see dvs_simd.hpp)
+    T_buf_.resize(plane);
+    E_buf_.resize(plane);
+    I_buf_.resize(plane);
     if (surfaceMapLastTs) {
-        const float tau_us = 5e5f;
-        for (int y = 0; y < sH; ++y) {
-            for (int x = 0; x < sW; ++x) {
-                float last = surfaceMapLastTs[y][x];
-                float dt   = std::max(0.f, (float)latest_ts - last);
-                T_buf_[y * sW + x] = std::clamp(std::exp(-dt / tau_us), 0.f, 1.f);
-            }
-        }
+        decay_lut_.build(5e5f);
+        simd::timeSurface(surfaceMapLastTs, plane, (float)latest_ts, decay_lut_, T_buf_.data());
+    } else {
+        std::fill(T_buf_.begin(), T_buf_.end(), 0.f);
     }
 
-    // Convert intensity to grayscale (matches original which called setImageType(OF_IMAGE_GRAYSCALE))
-    E_buf_.assign(plane, 0.f);
-    ofPixels grayPx;
-    bool haveGray = false;
+    // Grayscale + Sobel edges + intensity in one pass (matches original which
+    // called setImageType(OF_IMAGE_GRAYSCALE))
     if (intensity.isAllocated() && (int)intensity.getWidth() == sW && (int)intensity.getHeight() == sH) {
-        if (intensity.getNumChannels() == 1) {
-            grayPx = intensity;
-        } else {
-            grayPx.allocate(sW, sH, OF_IMAGE_GRAYSCALE);
-            const int nc = intensity.getNumChannels();
-            for (int y = 0; y < sH; ++y) {
-                for (int x = 0; x < sW; ++x) {
-                    size_t src = ((size_t)y * sW + x) * nc;
-                    unsigned char r = intensity[src + 0];
-                    unsigned char g = intensity[src + 1];
-                    unsigned char b = intensity[src + 2];
-                    grayPx[y * sW + x] = (unsigned char)(0.299f*r + 0.587f*g + 0.114f*b);
-                }
-            }
-        }
-        haveGray = true;
+        gray_buf_.resize(plane);
+        simd::grayEdgeIntensity(intensity.getData(), (int)intensity.getNumChannels(), sW, sH,
+                                gray_buf_.data(), E_buf_.data(), I_buf_.data());
+    } else {
+        std::fill(E_buf_.begin(), E_buf_.end(), 0.f);
+        std::fill(I_buf_.begin(), I_buf_.end(), 0.f);
     }
 
-    // Edge magnitude (Sobel) from grayscale intensity
-    if (haveGray) {
-        auto P = [&](int yy, int xx) -> unsigned char { return grayPx[yy * sW + xx]; };
-        for (int y = 1; y < sH - 1; ++y) {
-            for (int x = 1; x < sW - 1; ++x) {
-                float gx = float(P(y-1,x+1) + 2*P(y,x+1) + P(y+1,x+1)
-                               - P(y-1,x-1) - 2*P(y,x-1) - P(y+1,x-1));
-                float gy = float(P(y+1,x-1) + 2*P(y+1,x) + P(y+1,x+1)
-                               - P(y-1,x-1) - 2*P(y-1,x) - P(y-1,x+1));
-                float mag = std::sqrt(gx*gx + gy*gy) / (4.f * 255.f);
-                E_buf_[y * sW + x] = std::clamp(mag, 0.f, 1.f);
-            }
+    // Resample all five channels to model resolution, a row at a time
+    // (channel-outer within the row).  Padding is never written, pooled
+    // buffers keep it at zero.
+    const size_t mplane = (size_t)model_H_ * model_W_;
+    const size_t newW = (size_t)lb_plan_.outW();
+    const int    newH = lb_plan_.outH();
+    const float count_scale = 5.0f;
+    const float* planes[5] = {pos_buf_.data(), neg_buf_.data(), T_buf_.data(),
+                              E_buf_.data(), I_buf_.data()};
+
+    auto resampleRow = [&](int j, float* const d[5]) {
+        for (int c = 0; c < 5; ++c) lb_plan_.row(planes[c], j, d[c]);
+        for (int c = 0; c < 2; ++c)
+            for (size_t i = 0; i < newW; ++i) d[c][i] = std::min(1.f, d[c][i] / count_scale);
+    };
+
+    VteiTensor out;
+    out.lb_scale = lb_scale_;
+    out.lb_padx  = lb_padx_;
+    out.lb_pady  = lb_pady_;
+    if (half_input_) {
+        // Float16 model: resample a row of each channel, convert straight
+        // into the half tensor (no full-size float tensor, no conversion in ORT)
+        out.f16 = vtei_pool16_.acquire();
+        uint16_t* dst = out.f16->data();
+        float* r = row_buf_.data();
+        float* const rows[5] = {r, r + newW, r + 2 * newW, r + 3 * newW, r + 4 * newW};
+        for (int j = 0; j < newH; ++j) {
+            resampleRow(j, rows);
+            const size_t mrow = (size_t)(j + lb_pady_) * model_W_ + lb_padx_;
+            for (size_t c = 0; c < 5; ++c)
+                simd::f32ToF16(rows[c], dst + c * mplane + mrow, newW);
         }
-    }
-
-    // Pack into CHW (C=5: pos, neg, T, E, I)
-    const size_t C5 = 5;
-    chw5_sensor_.resize(C5 * plane);
-
-    for (int y = 0; y < sH; ++y) {
-        for (int x = 0; x < sW; ++x) {
-            size_t hw = (size_t)y * sW + x;
-            float i01 = (haveGray ? grayPx[hw] / 255.f : 0.f);
-            chw5_sensor_[0 * plane + hw] = pos_buf_[hw];
-            chw5_sensor_[1 * plane + hw] = neg_buf_[hw];
-            chw5_sensor_[2 * plane + hw] = T_buf_[hw];
-            chw5_sensor_[3 * plane + hw] = E_buf_[hw];
-            chw5_sensor_[4 * plane + hw] = i01;
+    } else {
+        out.f32 = vtei_pool_.acquire();
+        float* dst = out.f32->data();
+        for (int j = 0; j < newH; ++j) {
+            const size_t m = (size_t)(j + lb_pady_) * model_W_ + lb_padx_;
+            float* const rows[5] = {dst + m, dst + mplane + m, dst + 2 * mplane + m,
+                                    dst + 3 * mplane + m, dst + 4 * mplane + m};
+            resampleRow(j, rows);
         }
     }
 
-    return chw5_sensor_;
+    return out;
 }
 
 // ---- infer ----
-void YoloPipeline::infer(const std::vector<float>& vtei_sensor_chw,
-                          int sensorW, int sensorH)
+void YoloPipeline::infer(const VteiTensor& vtei, int sensorW, int sensorH)
 {
+    // A new model is waiting to be swapped in: keep the last detections
+    if (swap_pending_) return;
+    std::lock_guard<std::mutex> lk(run_mu_);
     if (!nn_ || !nn_->isLoaded()) { dets_.clear(); return; }
 
-    ensureLetterboxParams_(sensorW, sensorH);
-
     const int C5 = 5;
 
-    // Letterbox sensor -> model
-    chw5_model_ = nn::letterboxCHW(
-        vtei_sensor_chw, C5, sensorH, sensorW,
-        model_H_, model_W_, lb_scale_, lb_padx_, lb_pady_);
-
-    if (chw5_model_.size() != (size_t)C5 * model_H_ * model_W_) {
-        ofLogError() << "[YOLO] letterbox produced wrong size";
+    // Tensor comes letterboxed from buildVTEI(); letterbox params are cached there
+    if (vtei.size() != (size_t)C5 * model_H_ * model_W_ || bool(vtei.f16) != half_input_) {
+        ofLogError() << "[YOLO] VTEI tensor has wrong size/precision " << vtei.size();
         dets_.clear();
         return;
     }
 
-    // Run ONNX
-    nn_->runCHW_into(chw5_model_, C5, model_H_, model_W_, outmap_);
-    if (outmap_.empty()) { dets_.clear(); return; }
+    // Run ONNX (input bound zero-copy in the model's precision, output
+    // written in place)
+    const void* in = vtei.f16 ? (const void*)vtei.f16->data() : (const void*)vtei.f32->data();
+    nn_->runBoundRaw({in});
+    const std::vector<float>& out = nn_->boundOutput(out_idx_);
+    std::vector<YoloDet> cur_sensor;
+    if (!decode_(out.data(), out.size(), vtei, sensorW, sensorH, cur_sensor)) {
+        dets_.clear();
+        return;
+    }
 
-    // Find output
-    const std::vector<float>* pv = nullptr;
-    auto it0 = outmap_.find("output0");
-    if (it0 != outmap_.end()) pv = &it0->second;
-    else                      pv = &outmap_.begin()->second;
-    const std::vector<float>& v = *pv;
+    // Temporal smoothing (skipped when a tracker consumes the raw detections)
+    dets_ = cfg.smooth ? temporalSmooth_(cur_sensor) : std::move(cur_sensor);
 
-    // Decode: out0 = [1, C, N] where C = 4 + nc
-    const int nc = cfg.num_classes + 1; // PEDRo export uses nc=2
-    const int C  = 4 + nc;
-    if (v.size() % C != 0) {
-        ofLogError() << "[YOLO] unexpected output length=" << v.size() << " not divisible by C=" << C;
-        dets_.clear(); return;
+    for (auto& d : dets_) {
+        ofLogNotice() << "[YOLO] det cls=" << d.cls << " score=" << d.score
+                      << " rect=" << d.box;
     }
-    const int N = (int)(v.size() / C);
-    auto at = [&](int c, int i) -> float { return v[c * N + i]; };
+}
 
-    std::vector<nn::Det> raw_dets;
-    raw_dets.reserve(128);
+// ---- scoreFilter_ ----
+void YoloPipeline::scoreFilter_(const float* v, int N, int nc, std::vector<nn::Det>& out) const
+{
+    // sigmoid is monotonic: compare the best raw logit against
+    // logit(conf_thresh) and only take the exp() for the survivors
+    const float p = cfg.conf_thresh;
+    const float t = p <= 0.f ? -std::numeric_limits<float>::infinity()
+                  : p >= 1.f ?  std::numeric_limits<float>::infinity()
+                  : std::log(p / (1.f - p));
+
+    cls_max_.resize(N);
+    cls_arg_.resize(N);
+    simd::columnMaxArg(v + (size_t)4 * N, nc, (size_t)N, cls_max_.data(), cls_arg_.data());
+
+    auto at = [&](int c, int i) -> float { return v[(size_t)c * N + i]; };
     for (int i = 0; i < N; ++i) {
+        if (!(cls_max_[i] >= t)) continue;
         float cx = at(0,i), cy = at(1,i), w = at(2,i), h = at(3,i);
 
         if (cfg.normalized_coords) {
@@ -198,13 +270,8 @@ void YoloPipeline::infer(const std::vector<float>& vtei_sensor_chw,
             w  *= model_W_;  h  *= model_H_;
         }
 
-        int   best_cls = -1;
-        float best_p   = -1.f;
-        for (int c = 0; c < nc; ++c) {
-            float p = nn::sigmoid(at(4 + c, i));
-            if (p > best_p) { best_p = p; best_cls = c; }
-        }
-        if (best_p < cfg.conf_thresh) continue;
+        const float best_p = nn::sigmoid(cls_max_[i]);
+        if (best_p < cfg.conf_thresh) continue;   // rounding at the threshold
         if (w <= 1.f || h <= 1.f) continue;
         float ar = w / std::max(1.f, h);
         if (ar < 0.15f || ar > 6.7f) continue;
@@ -213,32 +280,199 @@ void YoloPipeline::infer(const std::vector<float>& vtei_sensor_chw,
         d.x1 = cx - 0.5f*w; d.y1 = cy - 0.5f*h;
         d.x2 = cx + 0.5f*w; d.y2 = cy + 0.5f*h;
         d.score = best_p;
-        d.cls   = best_cls;
-        raw_dets.push_back(d);
+        d.cls   = cls_arg_[i];
+        out.push_back(d);
+    }
+}
+
+// ---- decode_ ----
+bool YoloPipeline::decode_(const float* v, size_t len, const VteiTensor& geom, int sensorW, int sensorH,
+                           std::vector<YoloDet>& cur_sensor) const
+{
+    // Decode: out0 = [1, C, N] where C = 4 + nc
+    const int nc = cfg.num_classes + 1; // PEDRo export uses nc=2
+    const int C  = 4 + nc;
+    if (len % C != 0) {
+        ofLogError() << "[YOLO] unexpected output length=" << len << " not divisible by C=" << C;
+        return false;
     }
+    const int N = (int)(len / C);
 
-    // NMS
-    auto kept = nn::nms(std::move(raw_dets), cfg.iou_thresh);
+    std::vector<nn::Det>& kept = cand_;
+    kept.clear();
+    scoreFilter_(v, N, nc, kept);
+
+    // Class-aware NMS, in place
+    nn::nmsInPlace(kept, cfg.iou_thresh, nms_ws_, (size_t)std::max(0, cfg.nms_top_k));
 
     // Un-letterbox to sensor coords
-    std::vector<YoloDet> cur_sensor;
+    cur_sensor.clear();
     cur_sensor.reserve(kept.size());
     for (auto& k : kept) {
         auto r = nn::unletterboxToSensor(
             k.x1, k.y1, k.x2, k.y2,
-            lb_scale_, lb_padx_, lb_pady_,
+            geom.lb_scale, geom.lb_padx, geom.lb_pady,
             sensorW, sensorH);
         if (r.getWidth() > 0 && r.getHeight() > 0)
             cur_sensor.push_back(YoloDet{r, k.score, k.cls});
     }
 
-    // Temporal smoothing
-    dets_ = temporalSmooth_(cur_sensor);
+    return true;
+}
 
-    for (auto& d : dets_) {
-        ofLogNotice() << "[YOLO] det cls=" << d.cls << " score=" << d.score
-                      << " rect=" << d.box;
+// ---- benchmarkDecode ----
+void YoloPipeline::benchmarkDecode(int iters) {
+    iters = std::max(1, iters);
+
+    // ReYOLOv8m PEDRo head at 352x288: [1, 4 + 2, 44*36 + 22*18 + 11*9]
+    const int W = 352, H = 288, nc = 2, C = 4 + nc;
+    const int N = (W / 8) * (H / 8) + (W / 16) * (H / 16) + (W / 32) * (H / 32);
+    std::vector<float> out((size_t)C * N);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> ux(0.f, (float)W), uy(0.f, (float)H), us(4.f, 80.f);
+    std::normal_distribution<float> logit(-6.f, 3.f);   // few anchors above threshold
+    for (int i = 0; i < N; ++i) {
+        out[0 * (size_t)N + i] = ux(rng);
+        out[1 * (size_t)N + i] = uy(rng);
+        out[2 * (size_t)N + i] = us(rng);
+        out[3 * (size_t)N + i] = us(rng);
+        for (int c = 0; c < nc; ++c) out[(size_t)(4 + c) * N + i] = logit(rng);
+    }
+
+    std::lock_guard<std::mutex> lk(run_mu_);   // scratch buffers are shared with infer()
+    const YoloConfig saved = cfg;
+    cfg.num_classes = nc - 1;
+    cfg.normalized_coords = false;
+
+    // Reference: sigmoid of every class of every anchor, then the threshold
+    auto reference = [&](std::vector<nn::Det>& dets) {
+        const float* v = out.data();
+        for (int i = 0; i < N; ++i) {
+            int best_cls = -1; float best_p = -1.f;
+            for (int c = 0; c < nc; ++c) {
+                float p = nn::sigmoid(v[(size_t)(4 + c) * N + i]);
+                if (p > best_p) { best_p = p; best_cls = c; }
+            }
+            if (best_p < cfg.conf_thresh) continue;
+            float cx = v[i], cy = v[(size_t)N + i], w = v[2 * (size_t)N + i], h = v[3 * (size_t)N + i];
+            if (w <= 1.f || h <= 1.f) continue;
+            float ar = w / std::max(1.f, h);
+            if (ar < 0.15f || ar > 6.7f) continue;
+            nn::Det d;
+            d.x1 = cx - 0.5f*w; d.y1 = cy - 0.5f*h;
+            d.x2 = cx + 0.5f*w; d.y2 = cy + 0.5f*h;
+            d.score = best_p; d.cls = best_cls;
+            dets.push_back(d);
+        }
+    };
+
+    std::vector<nn::Det> a, b;
+    a.reserve(N); b.reserve(N);
+    double ms_ref = 0.0, ms_new = 0.0;
+    for (int it = 0; it < iters; ++it) {
+        a.clear(); b.clear();
+        auto t0 = std::chrono::steady_clock::now();
+        reference(a);
+        auto t1 = std::chrono::steady_clock::now();
+        scoreFilter_(out.data(), N, nc, b);
+        auto t2 = std::chrono::steady_clock::now();
+        ms_ref += std::chrono::duration<double, std::milli>(t1 - t0).count();
+        ms_new += std::chrono::duration<double, std::milli>(t2 - t1).count();
+    }
+
+    bool same = a.size() == b.size();
+    for (size_t k = 0; same && k < a.size(); ++k)
+        same = a[k].cls == b[k].cls && a[k].score == b[k].score && a[k].x1 == b[k].x1;
+    cfg = saved;
+
+    ofLogNotice() << "[YOLO decode bench] [1," << C << "," << N << "] x" << iters
+                  << " (" << simd::isaName(simd::activeIsa()) << "), " << a.size() << " survivors: "
+                  << "per-class sigmoid " << ms_ref / iters * 1000.0 << " us, "
+                  << "logit threshold " << ms_new / iters * 1000.0 << " us (x"
+                  << ms_ref / std::max(ms_new, 1e-9) << ")"
+                  << (same ? "" : "  MISMATCH");
+}
+
+// ---- benchmarkBatch ----
+void YoloPipeline::benchmarkBatch(int windows) {
+    if (!isLoaded()) { ofLogWarning() << "[YOLO batch bench] model not loaded"; return; }
+    windows = std::max(1, windows);
+
+    // Blank tensors in the model's precision: cost does not depend on content
+    const size_t n = (size_t)5 * model_H_ * model_W_;
+    std::vector<VteiTensor> vteis(windows);
+    for (auto& t : vteis) {
+        if (half_input_) t.f16 = std::make_shared<std::vector<uint16_t>>(n, 0);
+        else             t.f32 = std::make_shared<std::vector<float>>(n, 0.f);
+    }
+
+    const int saved = cfg.batch_size;
+    ofLogNotice() << "[YOLO batch bench] " << windows << " windows, "
+                  << (nn_->supportsBatch() ? "dynamic batch" : "fixed batch 1 (sequential)");
+    for (int b : {1, 2, 4, 8, 16}) {
+        if (b > windows) break;
+        cfg.batch_size = b;
+        inferBatch({vteis.begin(), vteis.begin() + b}, model_W_, model_H_);   // warm-up
+        auto t0 = std::chrono::steady_clock::now();
+        inferBatch(vteis, model_W_, model_H_);
+        auto t1 = std::chrono::steady_clock::now();
+        const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        ofLogNotice() << "[YOLO batch bench]   batch " << b << ": " << ms / windows
+                      << " ms/window, " << 1000.0 * windows / ms << " windows/s";
+    }
+    cfg.batch_size = saved;
+}
+
+// ---- inferBatch ----
+std::vector<std::vector<YoloDet>> YoloPipeline::inferBatch(
+    const std::vector<VteiTensor>& vteis, int sensorW, int sensorH)
+{
+    std::vector<std::vector<YoloDet>> results(vteis.size());
+    if (vteis.empty() || swap_pending_) return results;
+    std::lock_guard<std::mutex> lk(run_mu_);
+    if (!nn_ || !nn_->isLoaded()) return results;
+
+    const size_t need = (size_t)5 * model_H_ * model_W_;
+    for (const auto& t : vteis) {
+        if (t.size() != need || bool(t.f16) != half_input_) {
+            ofLogError() << "[YOLO] inferBatch: VTEI tensor has wrong size/precision " << t.size();
+            return results;
+        }
+    }
+    auto data = [](const VteiTensor& t) {
+        return t.f16 ? (const void*)t.f16->data() : (const void*)t.f32->data();
+    };
+
+    try {
+        // Fixed batch-1 export: same work, one bound run per tensor
+        if (!nn_->supportsBatch()) {
+            for (size_t k = 0; k < vteis.size(); ++k) {
+                nn_->runBoundRaw({data(vteis[k])});
+                const auto& out = nn_->boundOutput(out_idx_);
+                decode_(out.data(), out.size(), vteis[k], sensorW, sensorH, results[k]);
+            }
+            return results;
+        }
+
+        const size_t B = (size_t)std::max(1, cfg.batch_size);
+        const std::string out_name = nn_->outputs()[out_idx_].name;
+        const std::vector<int64_t> item_shape = tensorShape();
+        std::vector<const void*> items;
+        for (size_t k0 = 0; k0 < vteis.size(); k0 += B) {
+            const size_t n = std::min(B, vteis.size() - k0);
+            items.clear();
+            for (size_t k = 0; k < n; ++k) items.push_back(data(vteis[k0 + k]));
+
+            auto outs = nn_->runBatch(items, item_shape);
+            const auto& out = outs.at(out_name);
+            const size_t per = out.size() / n;
+            for (size_t k = 0; k < n; ++k)
+                decode_(out.data() + k * per, per, vteis[k0 + k], sensorW, sensorH, results[k0 + k]);
+        }
+    } catch (const std::exception& e) {
+        ofLogError() << "[YOLO] inferBatch error: " << e.what();
     }
+    return results;
 }
 
 // ---- temporalSmooth_ ----
@@ -323,7 +557,8 @@ void YoloPipeline::drawDetections(int sensorW, int sensorH) const {
                            ? cfg.class_names[d.cls]
                            : ("id:" + ofToString(d.cls));
         char buf[128];
-        std::snprintf(buf, sizeof(buf), "%s %.2f", name.c_str(), d.score);
+        if (d.id >= 0) std::snprintf(buf, sizeof(buf), "#%d %s %.2f", d.id, name.c_str(), d.score);
+        else           std::snprintf(buf, sizeof(buf), "%s %.2f", name.c_str(), d.score);
 
         if (cfg.show_labels) {
             ofPushMatrix();
@@ -342,6 +577,7 @@ void YoloPipeline::drawDetections(int sensorW, int sensorH) const {
 void YoloPipeline::clearHistory() {
     smooth_hist_.clear();
     dets_.clear();
+    gate.reset();
 }
 
 } // namespace dvs
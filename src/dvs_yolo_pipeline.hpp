@@ -9,11 +9,15 @@
 #include <deque>
 #include <string>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <atomic>
 
 #include "ofMain.h"
 #include "onnx_run.hpp"
 #include "dvs_nn_utils.hpp"
+#include "dvs_simd.hpp"
+#include "dvs_model_loader.hpp"
+#include "dvs_activity_gate.hpp"
 
 // Forward-declare the polarity struct used in ofxDVS.hpp
 struct polarity;
@@ -21,18 +25,39 @@ struct polarity;
 namespace dvs {
 
 /// Detection in sensor coordinates.
-struct YoloDet { ofRectangle box; float score; int cls; };
+struct YoloDet {
+    ofRectangle box;
+    float score;
+    int cls;
+    int id = -1;    ///< persistent track id (BoxTracker), -1 for raw detections
+};
+
+/// Model-resolution VTEI tensor in the model's input precision: exactly one
+/// of f32 / f16 is set (f16 holds IEEE binary16 bits for float16 models).
+struct VteiTensor {
+    nn::TensorPool::Ptr     f32;
+    nn::HalfTensorPool::Ptr f16;
+    /// Sensor -> model letterbox the tensor was built with; decoding uses
+    /// these, so a job built before a geometry change decodes correctly
+    float lb_scale = 1.f;
+    int   lb_padx  = 0, lb_pady = 0;
+    size_t size() const { return f16 ? f16->size() : (f32 ? f32->size() : 0); }
+};
 
 /// Runtime-tunable YOLO configuration.
 struct YoloConfig {
     float conf_thresh   = 0.8f;
     float iou_thresh    = 0.45f;
     int   smooth_frames = 2;      ///< Temporal smoothing history length (1..5)
+    bool  smooth        = true;   ///< Temporal smoothing (off when a BoxTracker follows the detections)
     bool  draw          = true;   ///< Draw overlay when true
     bool  show_labels   = true;
     float vtei_win_ms   = 50.0f;  ///< VTEI accumulation window in milliseconds
     int   num_classes   = 1;
     bool  normalized_coords = false; ///< Model outputs coords in [0,1] (scale by model dims)
+    int   batch_size    = 8;      ///< inferBatch() chunk: larger = more throughput, later first result
+    int   nms_top_k     = 1000;   ///< NMS considers the top-k candidates only (0 = all)
+    nn::ResampleMode resample = nn::ResampleMode::Nearest; ///< sensor -> model VTEI resampling
     std::vector<std::string> class_names = {"person"};
 };
 
@@ -42,28 +67,68 @@ class YoloPipeline {
 public:
     YoloPipeline() = default;
 
-    /// Load the ONNX model.  Call once during setup().
+    /// Load the ONNX model synchronously (blocks until ready).
     /// @param path      Absolute path to the .onnx file.
-    /// @param threads   Intra-op thread count (0 = use OnnxRunner default).
+    /// @param threads   Thread budget (0 = shared global ORT pool, N = private pool).
     void loadModel(const std::string& path, int threads = 0);
 
+    /// Start loading a model on a background thread.  The current model (if
+    /// any) keeps running until pollLoad() swaps the new one in.
+    /// @return false if a load is already in progress.
+    bool loadModelAsync(const std::string& path, int threads = 0);
+
+    /// Main thread, once per frame: install a finished background load.
+    /// Never blocks: while a swap is pending, infer() returns early so the
+    /// worker goes idle, and the swap happens on a later frame.
+    /// @return true when a new model was installed.
+    bool pollLoad();
+
+    LoadState loadState() const;
+    const std::string& loadError() const { return loader_.error(); }
+    const std::string& modelPath() const { return model_path_; }
+
     bool isLoaded() const { return nn_ && nn_->isLoaded(); }
 
     /// Build the 5-channel VTEI tensor (pos, neg, time-surface, edge, intensity)
     /// from the current event packet and image generator state.
-    /// Single-pass over packetsPolarity to find latest_ts and accumulate counts.
-    /// Returns CHW float buffer of size 5 * sensorH * sensorW.
-    std::vector<float> buildVTEI(
+    /// Dense channels (T, E, I) are computed on the sensor grid with the SIMD
+    /// kernels, then all five are resampled to model resolution through the
+    /// cached sensor->model letterbox plan (cfg.resample) into a pooled buffer,
+    /// so the result can be moved into an inference job without copying.
+    /// Float16 models get the tensor written directly in half precision
+    /// (rows resampled as float, converted with the F16C/NEON kernels).
+    /// Returns CHW buffer of size 5 * modelH * modelW (letterboxed).
+    VteiTensor buildVTEI(
         const std::vector<polarity>& events,
-        float** surfaceMapLastTs,
+        const float* surfaceMapLastTs,      ///< row-major sensorH x sensorW
         const ofPixels& intensityPixels,
         int sensorW, int sensorH);
 
-    /// Run inference on a pre-built VTEI tensor.  Performs letterbox, ONNX run,
-    /// output decoding, NMS, un-letterbox, and temporal smoothing.
+    /// Run inference on a VTEI tensor from buildVTEI() (model resolution,
+    /// already letterboxed).  Performs ONNX run, output decoding, NMS,
+    /// un-letterbox, and temporal smoothing.
     /// Stores results internally; retrieve with detections().
-    void infer(const std::vector<float>& vtei_sensor_chw,
-               int sensorW, int sensorH);
+    void infer(const VteiTensor& vtei, int sensorW, int sensorH);
+
+    /// Offline throughput: run several VTEI tensors from buildVTEI()
+    /// (consecutive windows, or windows from several streams of the same
+    /// sensor size) as [n, 5, H, W] calls of up to cfg.batch_size.
+    /// Returns the detections of each tensor, in order, in sensor
+    /// coordinates and without temporal smoothing.  Models exported with a
+    /// fixed batch of 1 are run one tensor at a time.  detections() is not
+    /// touched.
+    std::vector<std::vector<YoloDet>> inferBatch(const std::vector<VteiTensor>& vteis,
+                                                 int sensorW, int sensorH);
+
+    /// Time inferBatch() over `windows` blank tensors at batch sizes 1..16
+    /// and log ms per window (for tuning cfg.batch_size).  Call from the main
+    /// thread; competes with the live worker for the model.
+    void benchmarkBatch(int windows = 32);
+
+    /// Time the score filter of decoding on a synthetic ReYOLOv8m output
+    /// ([1, 6, 2079] at 352x288) against the per-class-sigmoid reference
+    /// and log us per frame.  Does not need a model.
+    void benchmarkDecode(int iters = 200);
 
     /// Draw bounding-box overlays in sensor coordinates.
     /// Caller should have set up the chip->screen transform.
@@ -79,28 +144,82 @@ public:
     /// Mutable config for GUI binding.
     YoloConfig cfg;
 
+    /// Activity gate consulted by the caller before building a tensor
+    /// (main thread); skipped frames keep the previous result.
+    ActivityGate gate;
+
+    /// Direct access to the underlying OnnxRunner (for benchmarks).
+    OnnxRunner* runner() { return nn_.get(); }
+
+    /// Shape of the tensors buildVTEI() returns ([1,5,H,W]).
+    std::vector<int64_t> tensorShape() const { return {1, 5, (int64_t)model_H_, (int64_t)model_W_}; }
+
 private:
     // Temporal smoothing helper
     std::vector<YoloDet> temporalSmooth_(const std::vector<YoloDet>& cur);
 
+    static OnnxRunner::Config runnerConfig_(const std::string& path, int threads);
+
+    /// Decode one image's output ([C, N], C = 4 + nc): score filter, NMS,
+    /// un-letterbox.  @return false on a malformed output.
+    bool decode_(const float* out, size_t len, const VteiTensor& geom, int sensorW, int sensorH,
+                 std::vector<YoloDet>& cur_sensor) const;
+
+    /// Score filter of decode_: anchors whose best class passes
+    /// cfg.conf_thresh (compared in logit space, sigmoid taken for the
+    /// survivors only) plus the box size/aspect checks, appended to `out`.
+    void scoreFilter_(const float* v, int N, int nc, std::vector<nn::Det>& out) const;
+
+    /// Adopt a loaded runner: bind I/O, reset model-dependent state
+    /// (caller holds run_mu_ or no worker is running).
+    void install_(std::unique_ptr<OnnxRunner> runner);
+
     std::unique_ptr<OnnxRunner> nn_;
+    std::string model_path_;
+
+    // Background load / hot swap
+    ModelLoader loader_;
+    std::unique_ptr<OnnxRunner> pending_;    ///< loaded, waiting for the swap
+    std::atomic<bool> swap_pending_{false};  ///< infer() stands aside while set
+    std::mutex run_mu_;                      ///< held by infer() and the swap
 
     // Model dimensions (filled on load)
     int model_H_ = 0, model_W_ = 0;
 
-    // Cached letterbox params (sensor -> model), recomputed when sensor size changes
+    // Cached letterbox params (sensor -> model), recomputed when sensor size
+    // changes (main thread only; the worker reads the copy in each VteiTensor)
     float lb_scale_ = 1.f;
     int   lb_padx_  = 0, lb_pady_ = 0;
     int   cached_sW_ = 0, cached_sH_ = 0;
 
+    /// Recompute letterbox params and the sensor->model resampling plan when
+    /// the sensor size or cfg.resample changes (main thread only).
     void ensureLetterboxParams_(int sensorW, int sensorH);
 
-    // Pre-allocated buffers (avoid per-frame allocation)
-    std::vector<float> pos_buf_, neg_buf_, T_buf_, E_buf_;
-    std::vector<float> chw5_sensor_, chw5_model_;
+    // Sensor -> model letterbox resampling (cached taps, see nn::ResamplePlan)
+    nn::ResamplePlan lb_plan_;
 
-    // Reusable output map for runCHW_into
-    std::unordered_map<std::string, std::vector<float>> outmap_;
+    // Pre-allocated buffers (avoid per-frame allocation)
+    std::vector<float> pos_buf_, neg_buf_;
+    std::vector<float> T_buf_, E_buf_, I_buf_;   ///< dense sensor-grid channels
+    std::vector<uint8_t> gray_buf_;
+    simd::DecayLUT decay_lut_;                   ///< time-surface exp(-dt/tau)
+
+    // Model-resolution VTEI tensors shared with the inference worker
+    // (half pool used when the model input is float16)
+    nn::TensorPool     vtei_pool_;
+    nn::HalfTensorPool vtei_pool16_;
+    bool half_input_ = false;
+    std::vector<float> row_buf_;                 ///< one resampled row per channel (f16 path)
+
+    // Decode scratch (under run_mu_): per-anchor best class logit / index
+    mutable std::vector<float>   cls_max_;
+    mutable std::vector<int32_t> cls_arg_;
+    mutable std::vector<nn::Det> cand_;          ///< score-filtered candidates, NMS'd in place
+    mutable nn::NmsWorkspace     nms_ws_;
+
+    // Bound output holding the detections ("output0", else the first)
+    int out_idx_ = 0;
 
     // Temporal smoothing state
     std::deque<std::vector<YoloDet>> smooth_hist_;
@@ -38,6 +38,7 @@ ofxDVS::ofxDVS() {
 // setupCore() — everything except GUI panel creation
 void ofxDVS::setupCore() {
     splitGuiMode_ = true;
+    setupStartTime_ = ofGetElapsedTimef();
 
     //thread_alpha.startThread();   // start usb thread
     thread.startThread();   // start usb thread
@@ -117,15 +118,11 @@ void ofxDVS::setupCore() {
         glPointSize(pointSizePx);
     }
 
-    // --- Event reconstruction (CPU per-pixel decay) ---
-    reconMap_.assign(sizeX * sizeY, 0.0f);
-    reconImage_.allocate(sizeX, sizeY, OF_IMAGE_COLOR);
+    // --- Event reconstruction (lazy per-pixel decay) ---
+    recon_.allocate(sizeX, sizeY);
 
     // --- Event-based optical flow (SAE + local plane fitting) ---
-    saeTimestamp_.assign(sizeX * sizeY, 0);
-    flowX_.assign(sizeX * sizeY, 0.0f);
-    flowY_.assign(sizeX * sizeY, 0.0f);
-    flowImage_.allocate(sizeX, sizeY, OF_IMAGE_COLOR);
+    optical_flow_.allocate(sizeX, sizeY);
 
     // imagePol
     imagePolarity.allocate(sizeX, sizeY, OF_IMAGE_COLOR);
@@ -187,42 +184,46 @@ void ofxDVS::setupCore() {
 
     glPointSize(1);
 
-    // --- Load YOLO model via pipeline ---
-    try {
-        yolo_pipeline.loadModel(ofToDataPath("ReYOLOv8m_PEDRO_352x288.onnx", true));
-    } catch (const std::exception& e) {
-        ofLogError() << "Failed to load YOLO: " << e.what();
-    }
-
-    // --- Load TSDT model via pipeline ---
-    try {
-        tsdt_pipeline.loadModel(ofToDataPath("sew_resnet_dvs_gesture.onnx",true));//tp_gesture_128x128.onnx", true));
-        tsdt_pipeline.selfTest();
-        if (ofFile::doesFileExist(ofToDataPath("tsdt_input_fp32.bin", true))) {
-            tsdt_pipeline.debugFromFile(ofToDataPath("tsdt_input_fp32.bin", true));
-        }
-    } catch (const std::exception& e) {
-        ofLogError() << "Failed to load TSDT: " << e.what();
-    }
-
-    // --- Load TPDVSGesture model via pipeline ---
-    try {
-        tpdvs_gesture_pipeline.cfg.T = 1;
-        tpdvs_gesture_pipeline.cfg.inH = 32;
-        tpdvs_gesture_pipeline.cfg.inW = 32;
-        tpdvs_gesture_pipeline.cfg.time_based_binning = true;
-        tpdvs_gesture_pipeline.cfg.bin_window_ms = 75.0f;
-        tpdvs_gesture_pipeline.cfg.stateful = true;
-        tpdvs_gesture_pipeline.cfg.ema_alpha = 1.0f;  // SNN state handles temporal integration
-        tpdvs_gesture_pipeline.cfg.label_y_offset = -80.f;
-        tpdvs_gesture_pipeline.cfg.log_tag = "TPDVSGesture";
-        tpdvs_gesture_pipeline.loadModel(ofToDataPath("tp_gesture_paper_32x32.onnx", true));
-    } catch (const std::exception& e) {
-        ofLogError() << "Failed to load TPDVSGesture: " << e.what();
-    }
-
-    // Start async inference workers
+    // One ORT environment and intra-op pool for all models (fixed by the
+    // first load below); models with a non-zero budget get a private pool
+    {
+        OnnxRunner::GlobalThreading gt;
+        gt.intra_op_threads = (int)std::max(1u, std::thread::hardware_concurrency() / 2);
+        gt.allow_spinning = false;
+        OnnxRunner::setGlobalThreading(gt);
+        // Optimized graphs are cached on disk, so later launches skip the
+        // ORT optimizer; every model gets a warm-up run at load
+        OnnxRunner::setOptimizedModelCache(ofToDataPath("ort_cache", true));
+    }
+
+    // --- Models load concurrently in the background; update() installs
+    // them as they finish (see pollModelLoads), so event ingestion and
+    // drawing start right away ---
+    tpdvs_gesture_pipeline.cfg.T = 1;
+    tpdvs_gesture_pipeline.cfg.inH = 32;
+    tpdvs_gesture_pipeline.cfg.inW = 32;
+    tpdvs_gesture_pipeline.cfg.time_based_binning = true;
+    tpdvs_gesture_pipeline.cfg.bin_window_ms = 75.0f;
+    tpdvs_gesture_pipeline.cfg.stateful = true;
+    tpdvs_gesture_pipeline.cfg.ema_alpha = 1.0f;  // SNN state handles temporal integration
+    tpdvs_gesture_pipeline.cfg.label_y_offset = -80.f;
+    tpdvs_gesture_pipeline.cfg.log_tag = "TPDVSGesture";
+
+    yolo_pipeline.loadModelAsync(ofToDataPath("ReYOLOv8m_PEDRO_352x288.onnx", true), nnThreadBudgetYolo);
+    tsdt_pipeline.loadModelAsync(ofToDataPath("sew_resnet_dvs_gesture.onnx", true), nnThreadBudgetTsdt);//tp_gesture_128x128.onnx", true));
+    tpdvs_gesture_pipeline.loadModelAsync(ofToDataPath("tp_gesture_paper_32x32.onnx", true), nnThreadBudgetTpdvs);
+    // Optional crop model for ROI inference on tracker clusters
+    if (ofFile::doesFileExist(ofToDataPath("roi_model.onnx", true)))
+        roi_pipeline.loadModelAsync(ofToDataPath("roi_model.onnx", true), nnThreadBudgetRoi);
+
+    // Start async inference workers.  YOLO is stateless, so a newer frame may
+    // replace a queued one; the gesture pipelines consume their history per
+    // accepted tensor (and may carry SNN state), so they keep drop-if-busy.
+    yolo_worker.setMode(dvs::SubmitMode::LatestWins);
     yolo_worker.start();
+    tsdt_worker.start();
+    tpdvs_worker.start();
+    roi_worker.start();
 
     // hot pixels
     const size_t npix = this->sizeX * this->sizeY;
@@ -232,6 +233,13 @@ void ofxDVS::setupCore() {
     hot_pixel_mask_.assign(npix, false);
     hot_calib_done_ = false;
     hot_calib_started_ = false;
+
+    // flicker suppression
+    flicker_cells_.assign(npix, FlickerCell{});
+    flicker_removed_frac_ = 0.0f;
+
+    // event coordinate remap LUT for the current sensor size
+    reloadEventRemap();
 }
 
 //--------------------------------------------------------------
@@ -276,6 +284,7 @@ void ofxDVS::setupGUI() {
     f1->addToggle("DVS Image Gen", false);
     f1->addToggle("HOT PIXEL FILTER", hotPixelFilterEnabled_);
     f1->addToggle("BA FILTER", baFilterEnabled_);
+    f1->addToggle("FLICKER FILTER", flickerFilterEnabled_);
     f1->addSlider("DVS Integration", 1, 100, fsint);
     f1->addSlider("DVS Image Gen", 1, 20000, numSpikes);
     f1->addToggle("ENABLE OPTICAL FLOW", false);
@@ -394,6 +403,9 @@ void ofxDVS::tryLive(){
 
     tsdt_pipeline.clearHistory();
     yolo_pipeline.clearHistory();
+    box_tracker.clear();
+    roi_pipeline.clearHistory();
+    recon_.clear();
     tpdvs_gesture_pipeline.clearHistory();
 }
 
@@ -443,6 +455,9 @@ void ofxDVS::changePath(){
 
     tsdt_pipeline.clearHistory();
     yolo_pipeline.clearHistory();
+    box_tracker.clear();
+    roi_pipeline.clearHistory();
+    recon_.clear();
     tpdvs_gesture_pipeline.clearHistory();
     resetPlaybackTiming();
 }
@@ -680,12 +695,18 @@ bool ofxDVS::organizeData(caerEventPacketContainer packetContainer){
         if (type == POLARITY_EVENT  && dvsStatus) {
 
             caerPolarityEventPacket polarity = (caerPolarityEventPacket) packetHeader;
+            const bool remap = event_remap.isActive(sizeX, sizeY);
 
             CAER_POLARITY_ITERATOR_VALID_START(polarity)
+            int ex = caerPolarityEventGetX(caerPolarityIteratorElement);
+            int ey = caerPolarityEventGetY(caerPolarityIteratorElement);
+            // undistort / rotate / crop; drop events that map off-sensor
+            if (remap && !event_remap.apply(ex, ey)) continue;
+
             nuPack.timestamp = caerPolarityEventGetTimestamp64(caerPolarityIteratorElement, polarity);
 
-            nuPack.pos.x = caerPolarityEventGetX(caerPolarityIteratorElement);
-            nuPack.pos.y = caerPolarityEventGetY(caerPolarityIteratorElement);
+            nuPack.pos.x = ex;
+            nuPack.pos.y = ey;
 
             nuPack.pol = caerPolarityEventGetPolarity(caerPolarityIteratorElement);
 
@@ -774,6 +795,8 @@ bool ofxDVS::organizeData(caerEventPacketContainer packetContainer){
 //--------------------------------------------------------------
 void ofxDVS::update() {
 
+    load_governor.beginFrame();
+
     if(paused == false){
         // Copy data from usbThread
         // 1) take ownership quickly
@@ -784,6 +807,7 @@ void ofxDVS::update() {
             (thread.sizeX != sizeX || thread.sizeY != sizeY)) {
             sizeX = thread.sizeX;
             sizeY = thread.sizeY;
+            event_remap.build(sizeX, sizeY);
             if (rectangularClusterTrackerEnabled) createRectangularClusterTracker();
             updateViewports();
         }
@@ -802,17 +826,21 @@ void ofxDVS::update() {
             std::fill(last_ts_map_.begin(), last_ts_map_.end(), 0);
             std::fill(hot_rate_count_.begin(), hot_rate_count_.end(), 0);
             hot_rate_window_start_ = 0;
+            resetFlickerFilter_();
             for (int i = 0; i < sizeX; ++i)
                 for (int j = 0; j < sizeY; ++j)
                     baFilterMap[i][j] = 0;
 
-            // Reset optical flow SAE timestamps
-            std::fill(saeTimestamp_.begin(), saeTimestamp_.end(), 0);
+            // Reset optical flow SAE timestamps and the reconstruction
+            optical_flow_.clear();
+            recon_.clear();
 
             // Clear all NN pipeline histories for deterministic results
             tpdvs_gesture_pipeline.clearHistory();
             tsdt_pipeline.clearHistory();
             yolo_pipeline.clearHistory();
+            box_tracker.clear();
+            roi_pipeline.clearHistory();
         }
 
         // Prepend any deferred packets from last frame
@@ -865,14 +893,18 @@ void ofxDVS::update() {
                     std::fill(last_ts_map_.begin(), last_ts_map_.end(), 0);
                     std::fill(hot_rate_count_.begin(), hot_rate_count_.end(), 0);
                     hot_rate_window_start_ = 0;
+                    resetFlickerFilter_();
                     for (int fi = 0; fi < sizeX; ++fi)
                         for (int fj = 0; fj < sizeY; ++fj)
                             baFilterMap[fi][fj] = 0;
-                    std::fill(saeTimestamp_.begin(), saeTimestamp_.end(), 0);
+                    optical_flow_.clear();
+                    recon_.clear();
                     // Clear NN pipeline histories
                     tpdvs_gesture_pipeline.clearHistory();
                     tsdt_pipeline.clearHistory();
                     yolo_pipeline.clearHistory();
+                    box_tracker.clear();
+                    roi_pipeline.clearHistory();
                 }
 
                 if (playbackSpeed_ <= 0.0f) playbackSpeed_ = 0.01f;
@@ -925,182 +957,59 @@ void ofxDVS::update() {
 
     updateBAFilter();
     applyHotPixelFilter_();
+    applyFlickerFilter_();
+    applyDecimation_();
 
-    // --- Event-driven image reconstruction (CPU per-pixel decay) ---
+    // --- Event-driven image reconstruction (lazy per-pixel decay) ---
+    // Decay is applied on touch and on read, so cost scales with events.
     if (drawRecon) {
         const int W = sizeX, H = sizeY;
+        recon_.allocate(W, H);
+        recon_.beginFrame(reconDecay, reconContrib, reconSpread);
 
-        // 1) Decay all pixels towards zero every frame
-        for (auto &v : reconMap_) v *= reconDecay;
-
-        // 2) Apply events with spatial spread
+        // Governor may subsample; scale the contribution so brightness
+        // stays comparable
+        const int stride = load_governor.settings().stride;
+        int k = 0;
         for (const auto &e : packetsPolarity) {
             if (!e.valid) continue;
+            if ((k++ % stride) != 0) continue;
             int cx = (int)e.pos.x, cy = (int)e.pos.y;
-            float val = e.pol ? reconContrib : -reconContrib;
-            for (int dy = -reconSpread; dy <= reconSpread; dy++) {
-                for (int dx = -reconSpread; dx <= reconSpread; dx++) {
-                    int px = cx + dx, py = cy + dy;
-                    if (px < 0 || px >= W || py < 0 || py >= H) continue;
-                    float dist = std::sqrt((float)(dx*dx + dy*dy));
-                    if (dist > reconSpread) continue;
-                    float w = 1.0f - dist / (reconSpread + 1.0f);
-                    float &pix = reconMap_[py * W + px];
-                    pix = std::clamp(pix + val * w, -1.0f, 1.0f);
-                }
-            }
+            if (cx < 0 || cx >= W || cy < 0 || cy >= H) continue;
+            recon_.addEvent(cx, cy, e.pol, (float)stride);
         }
 
-        // 3) Map to yellow (ON) / blue (OFF) colors
-        unsigned char *raw = reconImage_.getPixels().getData();
-        for (int i = 0; i < W * H; i++) {
-            float v = reconMap_[i];
-            int idx = i * 3;
-            if (v > 0) {
-                raw[idx]     = (unsigned char)(v * 255);
-                raw[idx + 1] = (unsigned char)(v * 200);
-                raw[idx + 2] = 0;
-            } else {
-                float a = -v;
-                raw[idx]     = 0;
-                raw[idx + 1] = (unsigned char)(a * 100);
-                raw[idx + 2] = (unsigned char)(a * 255);
-            }
-        }
-        reconImage_.update();
+        recon_.render();
     }
 
     // --- Event-based optical flow (SAE + local plane fitting) ---
     {
-        const int W = sizeX, H = sizeY;
-        const int R = optFlowRadius;
-        const int64_t dtThresh = (int64_t)optFlowDt_us;
+        optical_flow_.allocate(sizeX, sizeY);
 
         // Always update SAE with valid events (keeps the map warm)
-        for (const auto &e : packetsPolarity) {
-            if (!e.valid) continue;
-            int ex = (int)e.pos.x, ey = (int)e.pos.y;
-            if (ex >= 0 && ex < W && ey >= 0 && ey < H)
-                saeTimestamp_[ey * W + ex] = e.timestamp;
-        }
+        optical_flow_.updateSAE(packetsPolarity);
 
         if (drawOptFlow) {
-            // Decay existing flow vectors
-            for (int i = 0, n = W * H; i < n; i++) {
-                flowX_[i] *= optFlowDecay;
-                flowY_[i] *= optFlowDecay;
-            }
-
-            // Compute flow per valid event via local plane fitting
-            for (const auto &e : packetsPolarity) {
-                if (!e.valid) continue;
-                int ex = (int)e.pos.x, ey = (int)e.pos.y;
-                if (ex < R || ex >= W - R || ey < R || ey >= H - R) continue;
-
-                int64_t t0 = e.timestamp;
-
-                // Accumulate normal equations for t = a*dx + b*dy + c
-                // Using Cramer's rule on the 3x3 system:
-                //   [sum(dx^2)  sum(dx*dy) sum(dx) ] [a]   [sum(dx*t)]
-                //   [sum(dx*dy) sum(dy^2)  sum(dy) ] [b] = [sum(dy*t)]
-                //   [sum(dx)    sum(dy)    N       ] [c]   [sum(t)   ]
-                double Sxx = 0, Syy = 0, Sxy = 0, Sx = 0, Sy = 0;
-                double Sxt = 0, Syt = 0, St = 0;
-                int N = 0;
-
-                for (int dy = -R; dy <= R; dy++) {
-                    for (int dx = -R; dx <= R; dx++) {
-                        int64_t ts = saeTimestamp_[(ey + dy) * W + (ex + dx)];
-                        if (ts == 0) continue;
-                        int64_t age = t0 - ts;
-                        if (age < 0 || age > dtThresh) continue;
-                        double dt = (double)(ts - t0); // relative timestamp (negative or zero)
-                        Sxx += dx * dx;
-                        Syy += dy * dy;
-                        Sxy += dx * dy;
-                        Sx  += dx;
-                        Sy  += dy;
-                        Sxt += dx * dt;
-                        Syt += dy * dt;
-                        St  += dt;
-                        N++;
-                    }
-                }
-
-                if (N < 6) continue; // need enough neighbors for robust fit
-
-                // Solve 3x3 system via Cramer's rule
-                // M = [[Sxx, Sxy, Sx], [Sxy, Syy, Sy], [Sx, Sy, N]]
-                double det = Sxx * (Syy * N - Sy * Sy)
-                           - Sxy * (Sxy * N - Sy * Sx)
-                           + Sx  * (Sxy * Sy - Syy * Sx);
-
-                if (std::abs(det) < 1e-6) continue; // near-singular
-
-                double detA = Sxt * (Syy * N - Sy * Sy)
-                            - Sxy * (Syt * N - Sy * St)
-                            + Sx  * (Syt * Sy - Syy * St);
-
-                double detB = Sxx * (Syt * N - Sy * St)
-                            - Sxt * (Sxy * N - Sy * Sx)
-                            + Sx  * (Sxy * St - Syt * Sx);
-
-                double a = detA / det; // dt/dx in microseconds/pixel
-                double b = detB / det; // dt/dy in microseconds/pixel
-
-                // Flow velocity: vx = -1/a, vy = -1/b (pixels/us) → convert to px/s
-                if (std::abs(a) < 1e-10 && std::abs(b) < 1e-10) continue;
-
-                float vx = 0, vy = 0;
-                // Use the gradient vector directly: v = -(a,b) / (a^2+b^2) * 1e6
-                double denom = a * a + b * b;
-                if (denom < 1e-20) continue;
-                vx = (float)(-a / denom * 1e6);
-                vy = (float)(-b / denom * 1e6);
-
-                float mag = std::sqrt(vx * vx + vy * vy);
-                if (mag > optFlowMaxSpeed * 5.0f) continue; // reject outliers
-
-                int idx = ey * W + ex;
-                flowX_[idx] = vx;
-                flowY_[idx] = vy;
-            }
-
-            // Render flow as HSV color wheel
-            unsigned char *raw = flowImage_.getPixels().getData();
-            for (int i = 0; i < W * H; i++) {
-                float vx = flowX_[i], vy = flowY_[i];
-                float mag = std::sqrt(vx * vx + vy * vy);
-                int idx3 = i * 3;
-                if (mag < 0.5f) {
-                    raw[idx3] = raw[idx3 + 1] = raw[idx3 + 2] = 0;
-                    continue;
-                }
-
-                // Hue from angle [0, 360)
-                float hue = std::atan2(vy, vx) * (180.0f / M_PI) + 180.0f;
-                float sat = 1.0f;
-                float val = std::min(mag / optFlowMaxSpeed, 1.0f);
-
-                // HSV to RGB
-                float c = val * sat;
-                float x = c * (1.0f - std::abs(std::fmod(hue / 60.0f, 2.0f) - 1.0f));
-                float m = val - c;
-                float r, g, b;
-                if      (hue < 60)  { r = c; g = x; b = 0; }
-                else if (hue < 120) { r = x; g = c; b = 0; }
-                else if (hue < 180) { r = 0; g = c; b = x; }
-                else if (hue < 240) { r = 0; g = x; b = c; }
-                else if (hue < 300) { r = x; g = 0; b = c; }
-                else                { r = c; g = 0; b = x; }
-                raw[idx3]     = (unsigned char)((r + m) * 255);
-                raw[idx3 + 1] = (unsigned char)((g + m) * 255);
-                raw[idx3 + 2] = (unsigned char)((b + m) * 255);
-            }
-            flowImage_.update();
+            // Per-event fits run in parallel over event chunks (the governor
+            // may subsample); the colour pass runs in parallel over rows.
+            optical_flow_.computeFlow(packetsPolarity, optFlowRadius, optFlowDt_us,
+                                      optFlowMaxSpeed, load_governor.settings().stride,
+                                      &worker_pool_,
+                                      optFlowIntegral ? dvs::FlowMethod::Integral
+                                                      : dvs::FlowMethod::PlaneFit);
+            optical_flow_.renderAndDecay(optFlowDecay, optFlowMaxSpeed, &worker_pool_);
         }
     }
 
+    // Packet summary for the NN activity gates (YOLO in the image
+    // generator, TSDT / TPDVSGesture below)
+    activity_.build(packetsPolarity, sizeX, sizeY);
+
+    // Detect-then-track: move the boxes with every packet, not only the
+    // ones that complete an image frame
+    if (nnEnabled && yoloTrack && !packetsPolarity.empty())
+        box_tracker.propagate(packetsPolarity, packetsPolarity.back().timestamp);
+
     updateImageGenerator();
 
     // --- FEED RECTANGULAR CLUSTER TRACKER ---
@@ -1133,25 +1042,135 @@ void ofxDVS::update() {
         }
     }
 
-    // ---- TSDT: push events and run inference (synchronous) ----
+    // Install models that finished loading in the background
+    pollModelLoads();
+
+    // ---- TSDT / TPDVSGesture: push events, snapshot tensor, infer on workers ----
     if (!packetsPolarity.empty()) {
         tsdt_pipeline.pushEvents(packetsPolarity, sizeX, sizeY);
         tpdvs_gesture_pipeline.pushEvents(packetsPolarity, sizeX, sizeY);
 
-        if (tsdtEnabled && tsdt_pipeline.isLoaded()) {
-            tsdt_pipeline.infer(sizeX, sizeY);
+        // Only prepare when the worker is idle, so events are not consumed
+        // for a tensor that would be dropped.  prepare() can still decline
+        // (rate limit, bins not filled), so the gate is committed after it.
+        if (tsdtEnabled && tsdt_pipeline.isLoaded() && !tsdt_worker.isBusy()) {
+            if (!tsdt_pipeline.gate.wouldAdmit(activity_)) {
+                tsdt_pipeline.gate.skip();
+            } else {
+                dvs::TsdtInput in;
+                if (tsdt_pipeline.prepare(sizeX, sizeY, in)) {
+                    tsdt_pipeline.gate.commit(activity_);
+                    calib_recorder.record("tsdt", in.tensor.data(), in.tensor.size(), tsdt_pipeline.tensorShape(),
+                                          tsdt_pipeline.isStateful() ? (int64_t)in.epoch : -1);
+                    tsdt_worker.submit([this, in = std::move(in)]() {
+                        return tsdt_pipeline.runTensor(in);
+                    }, packetsPolarity.back().timestamp);
+                }
+            }
         }
-        if (tpdvsGestureEnabled && tpdvs_gesture_pipeline.isLoaded()) {
-            tpdvs_gesture_pipeline.infer(sizeX, sizeY);
+        if (tpdvsGestureEnabled && tpdvs_gesture_pipeline.isLoaded() && !tpdvs_worker.isBusy()) {
+            if (!tpdvs_gesture_pipeline.gate.wouldAdmit(activity_)) {
+                tpdvs_gesture_pipeline.gate.skip();
+            } else {
+                dvs::TsdtInput in;
+                if (tpdvs_gesture_pipeline.prepare(sizeX, sizeY, in)) {
+                    tpdvs_gesture_pipeline.gate.commit(activity_);
+                    calib_recorder.record("tpdvs", in.tensor.data(), in.tensor.size(), tpdvs_gesture_pipeline.tensorShape(),
+                                          tpdvs_gesture_pipeline.isStateful() ? (int64_t)in.epoch : -1);
+                    tpdvs_worker.submit([this, in = std::move(in)]() {
+                        return tpdvs_gesture_pipeline.runTensor(in);
+                    }, packetsPolarity.back().timestamp);
+                }
+            }
         }
     }
 
+    // ---- ROI: crops around the cluster tracker's visible clusters, one
+    // batched run per frame on its own worker ----
+    if (roiEnabled && rectangularClusterTrackerEnabled && rectangularClusterTracker
+        && roi_pipeline.isLoaded() && !packetsPolarity.empty()) {
+        const std::vector<ofRectangle> clusters = rectangularClusterTracker->getVisibleClusterBounds();
+        if (clusters.empty()) {
+            if (!roi_pipeline.detections().empty()) roi_pipeline.clearHistory();  // nothing left to box
+        } else if (!roi_worker.isBusy()) {
+            if (!roi_pipeline.gate.wouldAdmit(activity_)) {
+                roi_pipeline.gate.skip();
+            } else {
+                dvs::RoiInput in;
+                if (roi_pipeline.prepare(clusters, packetsPolarity, surfaceMapLastTs.data(), sizeX, sizeY, in)) {
+                    roi_pipeline.gate.commit(activity_);
+                    roi_worker.submit([this, in = std::move(in)]() {
+                        return roi_pipeline.run(in);
+                    }, packetsPolarity.back().timestamp);
+                }
+            }
+        }
+    }
+
+    load_governor.endFrame();
+
     //GUI
     if (!splitGuiMode_) updateGUI();
 
 }
 
 
+//--------------------------------------------------------------
+void ofxDVS::benchmarkOpticalFlow() {
+    dvs::OpticalFlow::benchmark(&worker_pool_);
+}
+
+//--------------------------------------------------------------
+void ofxDVS::pollModelLoads() {
+    yolo_pipeline.pollLoad();
+    if (tsdt_pipeline.pollLoad() && !tsdtSelfTested_) {
+        // One-time sanity checks on the first TSDT model
+        tsdtSelfTested_ = true;
+        tsdt_pipeline.selfTest();
+        if (ofFile::doesFileExist(ofToDataPath("tsdt_input_fp32.bin", true))) {
+            tsdt_pipeline.debugFromFile(ofToDataPath("tsdt_input_fp32.bin", true));
+        }
+    }
+    tpdvs_gesture_pipeline.pollLoad();
+    roi_pipeline.pollLoad();
+}
+
+//--------------------------------------------------------------
+void ofxDVS::reloadModel(const std::string& which, const std::string& path) {
+    if (which == "YOLO") {
+        yolo_pipeline.loadModelAsync(path.empty() ? yolo_pipeline.modelPath() : path, nnThreadBudgetYolo);
+    } else if (which == "TSDT") {
+        tsdt_pipeline.loadModelAsync(path.empty() ? tsdt_pipeline.modelPath() : path, nnThreadBudgetTsdt);
+    } else if (which == "TPDVSGesture") {
+        tpdvs_gesture_pipeline.loadModelAsync(path.empty() ? tpdvs_gesture_pipeline.modelPath() : path,
+                                              nnThreadBudgetTpdvs);
+    } else if (which == "ROI") {
+        const std::string p = !path.empty() ? path
+                            : !roi_pipeline.modelPath().empty() ? roi_pipeline.modelPath()
+                            : ofToDataPath("roi_model.onnx", true);
+        roi_pipeline.loadModelAsync(p, nnThreadBudgetRoi);
+    }
+}
+
+//--------------------------------------------------------------
+void ofxDVS::setActivityGates(const dvs::ActivityGateConfig& c) {
+    for (dvs::ActivityGate* g : {&yolo_pipeline.gate, &tsdt_pipeline.gate, &tpdvs_gesture_pipeline.gate,
+                                 &roi_pipeline.gate}) {
+        g->cfg = c;
+        g->reset();
+    }
+}
+
+//--------------------------------------------------------------
+void ofxDVS::benchmarkInference() {
+    OnnxRunner::benchmarkConcurrent({
+        {"YOLO",         yolo_pipeline.runner()},
+        {"TSDT",         tsdt_pipeline.runner()},
+        {"TPDVSGesture", tpdvs_gesture_pipeline.runner()},
+        {"ROI",          roi_pipeline.runner()},
+    });
+}
+
 //--------------------------------------------------------------
 void ofxDVS::loopColor() {
     if(paletteSpike < 2){
@@ -1275,6 +1294,62 @@ void ofxDVS::updateGUI() {
     f1->update();
     myTextTimer->setText(timeString);
     myTempReader->setText(to_string((int)(imuTemp)));
+    if (flickerStatDisplay)
+        flickerStatDisplay->setText(ofToString(flicker_removed_frac_ * 100.0f, 1) + " %");
+    if (governorCostDisplay)
+        governorCostDisplay->setText(ofToString(load_governor.costMs(), 1) + " ms (p="
+                                     + ofToString(load_governor.pressure(), 2) + ")");
+    if (governorSettingsDisplay)
+        governorSettingsDisplay->setText(load_governor.summary());
+
+    // Inference worker latency: queue wait / run time / result age, drops,
+    // and how far the shown result lags the newest events
+    const int64_t now_ts = packetsPolarity.empty() ? 0 : packetsPolarity.back().timestamp;
+    auto workerText = [now_ts](const dvs::WorkerStats& st) {
+        std::string txt = "w " + ofToString(st.queue_wait_ms, 1)
+                        + " r " + ofToString(st.run_ms, 1)
+                        + " age " + ofToString(st.result_age_ms, 0) + " ms"
+                        + " drop " + ofToString(st.dropped) + "/" + ofToString(st.submitted);
+        if (st.completed > 0 && now_ts > 0)
+            txt += " lag " + ofToString((now_ts - st.result_event_ts) / 1000.0, 0) + " ms";
+        return txt;
+    };
+    if (yoloWorkerDisplay)  yoloWorkerDisplay->setText(workerText(yolo_worker.stats()));
+    if (yoloTrackerDisplay)
+        yoloTrackerDisplay->setText(yoloTrack
+            ? ofToString(box_tracker.numTracks()) + " tracks, YOLO 1/" + ofToString(yoloDetectEvery) + " frames"
+            : "off (YOLO every frame)");
+    if (tsdtWorkerDisplay)  tsdtWorkerDisplay->setText(workerText(tsdt_worker.stats()));
+    if (tpdvsWorkerDisplay) tpdvsWorkerDisplay->setText(workerText(tpdvs_worker.stats()));
+    if (roiWorkerDisplay)
+        roiWorkerDisplay->setText(ofToString(roi_pipeline.lastCrops()) + " crops "
+                                  + ofToString(roi_pipeline.cropFraction() * 100.f, 1) + "% | "
+                                  + workerText(roi_worker.stats()));
+    if (gateDisplay) {
+        auto pct = [](const dvs::ActivityGate& g) { return ofToString(g.skipRate() * 100.f, 0) + "%"; };
+        gateDisplay->setText("skip YOLO " + pct(yolo_pipeline.gate) + " TSDT " + pct(tsdt_pipeline.gate)
+                             + " TPDVS " + pct(tpdvs_gesture_pipeline.gate) + " ROI " + pct(roi_pipeline.gate));
+    }
+
+    auto modelText = [](dvs::LoadState st, const std::string& path, const std::string& err) {
+        std::string txt = dvs::loadStateName(st);
+        if (st == dvs::LoadState::Failed) return txt + ": " + err;
+        if (!path.empty()) txt += ": " + ofFilePath::getFileName(path);
+        return txt;
+    };
+    if (yoloModelDisplay)
+        yoloModelDisplay->setText(modelText(yolo_pipeline.loadState(), yolo_pipeline.modelPath(),
+                                            yolo_pipeline.loadError()));
+    if (tsdtModelDisplay)
+        tsdtModelDisplay->setText(modelText(tsdt_pipeline.loadState(), tsdt_pipeline.modelPath(),
+                                            tsdt_pipeline.loadError()));
+    if (tpdvsModelDisplay)
+        tpdvsModelDisplay->setText(modelText(tpdvs_gesture_pipeline.loadState(),
+                                             tpdvs_gesture_pipeline.modelPath(),
+                                             tpdvs_gesture_pipeline.loadError()));
+    if (roiModelDisplay)
+        roiModelDisplay->setText(modelText(roi_pipeline.loadState(), roi_pipeline.modelPath(),
+                                           roi_pipeline.loadError()));
 }
 
 //--------------------------------------------------------------
@@ -1287,10 +1362,10 @@ void ofxDVS::drawViewer() {
     drawImageGenerator(); // if dvs.drawImageGen
     // Event-driven reconstruction image
     if (drawRecon) {
-        reconImage_.draw(0, 0, ofGetWidth(), ofGetHeight());
+        recon_.image().draw(0, 0, ofGetWidth(), ofGetHeight());
     }
     if (drawOptFlow) {
-        flowImage_.draw(0, 0, ofGetWidth(), ofGetHeight());
+        optical_flow_.image().draw(0, 0, ofGetWidth(), ofGetHeight());
     }
     drawSpikes();         // if dvs.doDrawSpikes
     drawImu6();
@@ -1298,11 +1373,35 @@ void ofxDVS::drawViewer() {
     drawRectangularClusterTracker();
 
     // YOLO detections from async worker
-    if (nnEnabled && yolo_worker.hasResult()) {
+    if (nnEnabled && yoloTrack) {
+        std::vector<dvs::YoloDet> fresh;
+        if (yolo_worker.takeResult(fresh))
+            box_tracker.update(fresh, yolo_worker.lastStamp().event_ts);
+        yolo_pipeline.detections() = box_tracker.detections(sizeX, sizeY);
+    } else if (nnEnabled && yolo_worker.hasResult()) {
         yolo_pipeline.detections() = yolo_worker.lastResult();
+        if (!firstYoloLogged_) {
+            firstYoloLogged_ = true;
+            ofLogNotice() << "[NN] first YOLO result " << (ofGetElapsedTimef() - setupStartTime_)
+                          << " s after setup";
+        }
     }
     yolo_pipeline.drawDetections(sizeX, sizeY);
 
+    // ROI crop results from async worker
+    {
+        dvs::RoiResult r;
+        if (roi_worker.takeResult(r)) roi_pipeline.applyResult(r);
+        if (roiEnabled) roi_pipeline.drawDetections(sizeX, sizeY);
+    }
+
+    // Gesture predictions from async workers
+    {
+        dvs::TsdtResult r;
+        if (tsdt_worker.takeResult(r))  tsdt_pipeline.applyResult(r);
+        if (tpdvs_worker.takeResult(r)) tpdvs_gesture_pipeline.applyResult(r);
+    }
+
     // TPDVSGesture label
     if (tpdvsGestureEnabled) {
         tpdvs_gesture_pipeline.drawLabel();
@@ -1723,6 +1822,8 @@ void ofxDVS::initVisualizerMap(){
 void ofxDVS::updateBAFilter(){
     if (!baFilterEnabled_) return;
 
+    const float deltaT = BAdeltaT * load_governor.settings().ba_scale;
+
     for (int i = 0; i < packetsPolarity.size(); i++) {
         ofPoint pos = packetsPolarity[i].pos;
 
@@ -1730,7 +1831,7 @@ void ofxDVS::updateBAFilter(){
         int lastTS = baFilterMap[(int)pos.x][(int)pos.y];
         int ts = packetsPolarity[i].timestamp;
 
-        if (( (ts - lastTS) >= BAdeltaT) || (lastTS == 0)) {
+        if (( (ts - lastTS) >= deltaT) || (lastTS == 0)) {
             // Filter out invalid, simply invalid them
             packetsPolarity[i].valid = false;
         }
@@ -1843,6 +1944,8 @@ void ofxDVS::exit() {
     // stop inference workers first (they may hold ONNX sessions)
     yolo_worker.stop();
     tsdt_worker.stop();
+    tpdvs_worker.stop();
+    roi_worker.stop();
 
     ofLogNotice() << "[ofxDVS] exit: stopping USB thread...";
 
@@ -2022,25 +2125,7 @@ void ofxDVS::initMeanRate(){
 // Image Generator
 //--------------------------------------------------------------
 void ofxDVS::initImageGenerator(){
-    spikeFeatures = new float*[sizeX];
-    for(int i = 0; i < sizeX; ++i){
-        spikeFeatures[i] = new float[sizeY];
-    }
-    for(int i = 0; i < sizeX; ++i){
-        for(int j = 0; j < sizeY; ++j){
-            spikeFeatures[i][j] = 0.0;
-        }
-    }
-    surfaceMapLastTs = new float*[sizeX];
-    for(int i = 0; i < sizeX; ++i){
-        surfaceMapLastTs[i] = new float[sizeY];
-    }
-    for(int i = 0; i < sizeX; ++i){
-        for(int j = 0; j < sizeY; ++j){
-            surfaceMapLastTs[i][j] = 0.0;
-        }
-    }
-    imageGenerator.allocate(sizeX, sizeY, OF_IMAGE_COLOR);
+    allocImageGeneratorMaps_();
     rectifyPolarities = false;
     numSpikes = 1500.0;
     counterSpikes = 0;
@@ -2049,6 +2134,20 @@ void ofxDVS::initImageGenerator(){
     newImageGen = false;
 }
 
+//--------------------------------------------------------------
+void ofxDVS::allocImageGeneratorMaps_(){
+    const size_t npix = (size_t)sizeX * sizeY;
+    spikeFeatures.assign(npix, 0.0f);
+    surfaceMapLastTs.assign(npix, 0.0f);
+    spikeTouched_.clear();
+    spikeTouched_.reserve(npix);
+    imageGenLit_.clear();
+    imageGenLit_.reserve(npix);
+    spikeSum_ = spikeSumSq_ = 0.0;
+    imageGenerator.allocate(sizeX, sizeY, OF_IMAGE_COLOR);
+    imageGenerator.getPixels().set(0);
+}
+
 //--------------------------------------------------------------
 void ofxDVS::drawImageGenerator() {
 
@@ -2141,117 +2240,120 @@ void ofxDVS::set3DTime(int i){
 //--------------------------------------------------------------
 void ofxDVS::updateImageGenerator(){
 
-    long lastTs;
-    for (int i = 0; i < packetsPolarity.size(); i++) {
-        // only valid
-        if(packetsPolarity[i].valid){
-            ofPoint pos = packetsPolarity[i].pos;
+    const int W = sizeX, H = sizeY;
+    if (spikeFeatures.size() != (size_t)W * H) {
+        // sensor size changed: re-allocate maps, keep user settings
+        allocImageGeneratorMaps_();
+        counterSpikes = 0;
+        newImageGen = false;
+    }
 
-            // update surfaceMap
-            if(packetsPolarity[i].pol){
-                spikeFeatures[(int)pos.x][(int)pos.y] = 1.0;
-            }else{
-                spikeFeatures[(int)pos.x][(int)pos.y] = 1.0;
-            }
+    // Accumulate features; running sums track touched pixels only
+    for (const auto &e : packetsPolarity) {
+        if (!e.valid) continue;
+        int x = (int)e.pos.x, y = (int)e.pos.y;
+        if ((unsigned)x >= (unsigned)W || (unsigned)y >= (unsigned)H) continue;
+        int idx = y * W + x;
 
-            surfaceMapLastTs[(int)pos.x][(int)pos.y] = packetsPolarity[i].timestamp;
-            lastTs = packetsPolarity[i].timestamp;
-            counterSpikes = counterSpikes+1;
-        }
+        // update surfaceMap (both polarities map to 1.0)
+        float &f = spikeFeatures[idx];
+        const float nv = 1.0f;
+        if (f == 0.0f) spikeTouched_.push_back(idx);
+        spikeSum_   += nv - f;
+        spikeSumSq_ += nv * nv - f * f;
+        f = nv;
+
+        surfaceMapLastTs[idx] = e.timestamp;
+        counterSpikes = counterSpikes+1;
     }
 
     if(numSpikes <= counterSpikes){
 
         counterSpikes = 0;
-        // normalize
-        int sum = 0, count = 0;
-        for (int i = 0; i < sizeX; i++) {
-            for (int j = 0; j < sizeY; j++) {
-                if (spikeFeatures[i][j] != 0.0) {
-                    sum += spikeFeatures[i][j];
-                    count++;
-                }
-            }
-        }
-        float mean = sum / count;
-        float var = 0;
-        for (int i = 0; i < sizeX; i++) {
-            for (int j = 0; j < sizeY; j++) {
-                if (spikeFeatures[i][j] != 0.0) {
-                    float f = spikeFeatures[i][j] - mean;
-                    var += f * f;
-                }
-            }
-        }
+        // normalize (mean / variance from running sums over touched pixels)
+        const size_t count = spikeTouched_.size();
+        float mean = count ? (float)(spikeSum_ / count) : 0.0f;
+        float var  = count ? (float)(spikeSumSq_ / count) - mean * mean : 0.0f;
 
-        float sig = sqrt(var / count);
+        float sig = sqrt(std::max(0.0f, var));
         if (sig < (0.1f / 255.0f)) {
             sig = 0.1f / 255.0f;
         }
 
         float numSDevs = 3;
-        float mean_png_gray, range, halfrange;
-
-        if (rectifyPolarities) {
-            mean_png_gray = 0; // rectified
-        }
-
+        float range, halfrange;
         if (rectifyPolarities) {
             range = numSDevs * sig * (1.0f / 256.0f);
             halfrange = 0;
-        }
-
-        for (int col_idx = 0; col_idx < sizeX; col_idx++) {
-            for (int row_idx = 0; row_idx < sizeY; row_idx++) {
-                ofColor this_pixel;
-                this_pixel.set(0,0,0);
-                imageGenerator.setColor(col_idx,row_idx,this_pixel);
-            }
-        }
-        for (int col_idx = 0; col_idx < sizeX; col_idx++) {
-            for (int row_idx = 0; row_idx < sizeY; row_idx++) {
-                if (spikeFeatures[col_idx][row_idx] == 0) {
-                    spikeFeatures[col_idx][row_idx] = mean_png_gray;
-                }
-                else {
-                    float f = (spikeFeatures[col_idx][row_idx] + halfrange) / range;
-                    if (f > 255) {
-                        f = 255;
-                    }else if (f < 0) {
-                        f = 0;
-                    }
-                    ofColor this_pixel;
-                    this_pixel.set((int)floor(f), spkOnR[paletteSpike],spkOnG[paletteSpike]);
-                    imageGenerator.setColor(col_idx,row_idx,this_pixel);
-                }
-            }
-        }
-        // clear map
-        for (int col_idx = 0; col_idx < sizeX; col_idx++) {
-            for (int row_idx = 0; row_idx < sizeY; row_idx++) {
-                spikeFeatures[col_idx][row_idx]  = 0.0;
-            }
-        }
+        } else {
+            range = 2 * numSDevs * sig * (1.0f / 256.0f);
+            halfrange = numSDevs * sig;
+        }
+
+        // Clear only the pixels lit by the previous image
+        unsigned char *raw = imageGenerator.getPixels().getData();
+        const int nc = imageGenerator.getPixels().getNumChannels();
+        for (int idx : imageGenLit_) {
+            unsigned char *px = raw + (size_t)idx * nc;
+            px[0] = px[1] = px[2] = 0;
+        }
+        imageGenLit_.clear();
+
+        // Colour touched pixels directly into the buffer, then clear the map
+        const unsigned char g = (unsigned char)spkOnR[paletteSpike];
+        const unsigned char b = (unsigned char)spkOnG[paletteSpike];
+        for (int idx : spikeTouched_) {
+            float f = (spikeFeatures[idx] + halfrange) / range;
+            f = std::clamp(f, 0.0f, 255.0f);
+            unsigned char *px = raw + (size_t)idx * nc;
+            px[0] = (unsigned char)floor(f);
+            px[1] = g;
+            px[2] = b;
+            spikeFeatures[idx] = 0.0f;
+        }
+        imageGenLit_.swap(spikeTouched_);
+        spikeSum_ = spikeSumSq_ = 0.0;
         imageGenerator.update();
 
         newImageGen = true;
 
         // --- VTEI-based inference via async workers ---
-        bool needVTEI = (nnEnabled && yolo_pipeline.isLoaded());
-        if (needVTEI && newImageGen) {
-            // Build VTEI tensor on main thread (fast, uses pipeline pre-allocated buffers)
+        // In latest-wins mode every frame refreshes the worker's mailbox so
+        // the next run uses the newest events; in drop mode skip the build
+        // while the worker is busy (the job would be dropped anyway).
+        // Detect-then-track: between detector runs the tracker carries the
+        // boxes (propagated in update()); YOLO runs every yoloDetectEvery
+        // frames or when requested (DETECT NOW)
+        bool yoloDue = true;
+        if (nnEnabled && yoloTrack) {
+            yoloDue = yoloDetectNow_ || ++yoloFramesSinceDetect_ >= yoloDetectEvery;
+        }
+
+        const bool yoloLatest = yolo_worker.mode() == dvs::SubmitMode::LatestWins;
+        if (nnEnabled && yoloDue && yolo_pipeline.isLoaded() && (yoloLatest || !yolo_worker.isBusy())
+            && (yoloDetectNow_ || yolo_pipeline.gate.admit(activity_))) {
+            yoloFramesSinceDetect_ = 0;
+            yoloDetectNow_ = false;
+            // Build the model-resolution VTEI tensor on the main thread into a
+            // pooled buffer; ownership moves into the job (no copies)
             auto vtei = yolo_pipeline.buildVTEI(
-                packetsPolarity, surfaceMapLastTs,
+                packetsPolarity, surfaceMapLastTs.data(),
                 imageGenerator.getPixels(), sizeX, sizeY);
 
+            if (calib_recorder.active()) {
+                if (vtei.f16) calib_recorder.record("yolo", vtei.f16->data(), vtei.size(), yolo_pipeline.tensorShape());
+                else          calib_recorder.record("yolo", vtei.f32->data(), vtei.size(), yolo_pipeline.tensorShape());
+            }
+
             int sw = sizeX, sh = sizeY;
+            int64_t ets = packetsPolarity.empty() ? 0 : packetsPolarity.back().timestamp;
 
-            // Submit YOLO inference (non-blocking; dropped if worker is busy)
-            if (nnEnabled && yolo_pipeline.isLoaded()) {
-                yolo_worker.submit([this, vtei, sw, sh]() -> std::vector<dvs::YoloDet> {
+            // Submit YOLO inference (non-blocking; see SubmitMode)
+            {
+                yolo_worker.submit([this, vtei = std::move(vtei), sw, sh]() -> std::vector<dvs::YoloDet> {
                     yolo_pipeline.infer(vtei, sw, sh);
                     return yolo_pipeline.detections();
-                });
+                }, ets);
             }
         }
     }
@@ -2421,6 +2523,10 @@ void ofxDVS::onToggleEvent(ofxDatGuiToggleEvent e)
     }else if (e.target->is("BA FILTER")) {
         baFilterEnabled_ = e.target->getChecked();
         ofLogNotice() << "BA filter " << (baFilterEnabled_ ? "enabled" : "disabled");
+    }else if (e.target->is("FLICKER FILTER")) {
+        flickerFilterEnabled_ = e.target->getChecked();
+        if (!flickerFilterEnabled_) resetFlickerFilter_();
+        ofLogNotice() << "Flicker filter " << (flickerFilterEnabled_ ? "enabled" : "disabled");
     }else if (e.target->is("ENABLE NEURAL NETS")) {
         nnEnabled = e.target->getChecked();
         if (!nnEnabled) yolo_pipeline.clearHistory();
@@ -2498,6 +2604,7 @@ void ofxDVS::finalizeCalibration_() {
 void ofxDVS::applyHotPixelFilter_() {
     if (!hotPixelFilterEnabled_) return;
     const int W = sizeX, H = sizeY;
+    const int64_t refrac_us = (int64_t)(hot_refrac_us * load_governor.settings().refrac_scale);
 
     for (auto &e : packetsPolarity) {
         if (!e.valid) continue;
@@ -2532,7 +2639,7 @@ void ofxDVS::applyHotPixelFilter_() {
         // means new data that should be accepted.
         int64_t last = last_ts_map_[idx];
         int64_t dt = e.timestamp - last;
-        if (last != 0 && dt >= 0 && dt < hot_refrac_us) {
+        if (last != 0 && dt >= 0 && dt < refrac_us) {
             e.valid = false;
             continue;
         }
@@ -2555,6 +2662,121 @@ void ofxDVS::applyHotPixelFilter_() {
     }
 }
 
+// event remap: (re)load calibration and rebuild the per-pixel LUT
+void ofxDVS::reloadEventRemap() {
+    const std::string path = ofToDataPath("event_remap.yml", true);
+    if (event_remap.loadCalibration(path)) {
+        event_remap.enabled = true;
+    }
+    event_remap.build(sizeX, sizeY);
+}
+
+// flicker filter: suppress pixels locked to mains-frequency lighting.
+// A flickering source makes a pixel emit an ON burst and an OFF burst every
+// intensity cycle. A polarity change marks the onset of a burst; the interval
+// between consecutive onsets of the same polarity is the flicker period.
+// After flicker_lock_count in-band, mutually consistent periods the pixel is
+// considered locked and its events are dropped until the pattern breaks.
+// O(1) per event.
+void ofxDVS::applyFlickerFilter_() {
+    if (!flickerFilterEnabled_) {
+        flicker_removed_frac_ = 0.0f;
+        return;
+    }
+    const int W = sizeX, H = sizeY;
+    if (flicker_cells_.size() != (size_t)W * H)
+        flicker_cells_.assign((size_t)W * H, FlickerCell{});
+
+    const float lo_hz = std::max(1.0f, std::min(flicker_min_hz, flicker_max_hz));
+    const float hi_hz = std::max(lo_hz, std::max(flicker_min_hz, flicker_max_hz));
+    const int64_t min_period = (int64_t)(1e6f / hi_hz);
+    const int64_t max_period = (int64_t)(1e6f / lo_hz);
+    const int lock_needed = std::max(1, std::min(flicker_lock_count, 255));
+
+    size_t total = 0, removed = 0;
+    for (auto &e : packetsPolarity) {
+        if (!e.valid) continue;
+        int x = (int)e.pos.x, y = (int)e.pos.y;
+        if ((unsigned)x >= (unsigned)W || (unsigned)y >= (unsigned)H) {
+            e.valid = false;
+            continue;
+        }
+        ++total;
+        FlickerCell &c = flicker_cells_[y * W + x];
+        const uint8_t p = e.pol ? 1 : 0;
+
+        if (p != c.last_pol || c.onset_ts[p] == 0) {
+            // --- burst onset: measure period against the previous onset ---
+            int64_t interval = e.timestamp - c.onset_ts[p];
+            bool inBand = c.onset_ts[p] != 0 &&
+                          interval >= min_period && interval <= max_period;
+            bool consistent = inBand && c.period_us > 0 &&
+                std::abs(interval - (int64_t)c.period_us) <=
+                    (int64_t)(flicker_tolerance * c.period_us);
+            // lock saturates at lock_needed, so a single halving releases
+            // the pixel after a long flicker episode
+            if (consistent)
+                c.lock = (uint8_t)std::min(lock_needed, c.lock + 1);
+            else
+                c.lock = inBand ? (uint8_t)(c.lock / 2) : 0;   // tolerate one jittery cycle
+            c.period_us = inBand ? (int32_t)interval : 0;
+            c.onset_ts[p] = e.timestamp;
+            c.last_pol = p;
+        } else if (c.lock && e.timestamp - c.onset_ts[p] > 2 * (int64_t)c.period_us) {
+            // --- same-polarity run longer than two periods: no longer flickering ---
+            c.lock = 0;
+        }
+
+        if (c.lock >= lock_needed) {
+            e.valid = false;
+            ++removed;
+        }
+    }
+
+    if (total > 0) {
+        float frac = (float)removed / (float)total;
+        flicker_removed_frac_ = 0.9f * flicker_removed_frac_ + 0.1f * frac;
+    }
+}
+
+void ofxDVS::resetFlickerFilter_() {
+    std::fill(flicker_cells_.begin(), flicker_cells_.end(), FlickerCell{});
+    flicker_removed_frac_ = 0.0f;
+}
+
+// spatial decimation (load governor): pass at most one event per NxN block
+// per frame. Blocks are stamped with the frame counter so no per-frame clear
+// is needed.
+void ofxDVS::applyDecimation_() {
+    const int D = load_governor.settings().decimation;
+    if (D <= 1) return;
+    const int W = sizeX, H = sizeY;
+    const int BW = (W + D - 1) / D, BH = (H + D - 1) / D;
+    if (decim_block_frame_.size() < (size_t)BW * BH)
+        decim_block_frame_.assign((size_t)BW * BH, 0);
+
+    // stamps from earlier frames (or another block size) never match this one
+    if (++decim_frame_ == 0) {
+        std::fill(decim_block_frame_.begin(), decim_block_frame_.end(), 0);
+        decim_frame_ = 1;
+    }
+
+    for (auto &e : packetsPolarity) {
+        if (!e.valid) continue;
+        int x = (int)e.pos.x, y = (int)e.pos.y;
+        if ((unsigned)x >= (unsigned)W || (unsigned)y >= (unsigned)H) {
+            e.valid = false;
+            continue;
+        }
+        uint32_t &stamp = decim_block_frame_[(y / D) * BW + (x / D)];
+        if (stamp == decim_frame_) {
+            e.valid = false;
+            continue;
+        }
+        stamp = decim_frame_;
+    }
+}
+
 void ofxDVS::onTextInputEvent(ofxDatGuiTextInputEvent e)
 {
     cout << "onTextInputEvent" << endl;
@@ -64,8 +64,16 @@ enum class AedatFormat { UNKNOWN, AEDAT31, AEDAT4 };
 #include "onnx_run.hpp"
 #include "dvs_nn_utils.hpp"
 #include "dvs_yolo_pipeline.hpp"
+#include "dvs_box_tracker.hpp"
 #include "dvs_tsdt_pipeline.hpp"
+#include "dvs_roi_pipeline.hpp"
 #include "dvs_inference_worker.hpp"
+#include "dvs_calib_recorder.hpp"
+#include "dvs_load_governor.hpp"
+#include "dvs_event_remap.hpp"
+#include "dvs_event_recon.hpp"
+#include "dvs_optical_flow.hpp"
+#include "dvs_thread_pool.hpp"
 
 struct polarity {
     int info;
@@ -795,8 +803,8 @@ public:
 
     // Image Generator
     ofImage imageGenerator;
-    float** spikeFeatures;
-    float** surfaceMapLastTs;
+    std::vector<float> spikeFeatures;      // row-major [y * sizeX + x]
+    std::vector<float> surfaceMapLastTs;   // row-major [y * sizeX + x]
     bool rectifyPolarities;
     float numSpikes;
     int counterSpikes;
@@ -890,6 +898,7 @@ public:
     // --- Filter enable flags ---
     bool hotPixelFilterEnabled_ = true;
     bool baFilterEnabled_ = true;
+    bool flickerFilterEnabled_ = false;
 
     // Hot pixel suppression — tunable parameters (GUI-accessible)
     int hot_refrac_us = 200;
@@ -898,18 +907,84 @@ public:
 
     void recalibrateHotPixels();
 
+    // Flicker suppression — tunable parameters (GUI-accessible)
+    // Mains lighting modulates intensity at 2x the line frequency
+    // (100/120 Hz); some LED drivers flicker at the line frequency itself.
+    float flicker_min_hz = 45.0f;
+    float flicker_max_hz = 130.0f;
+    float flicker_tolerance = 0.15f;    // allowed relative period jitter
+    int   flicker_lock_count = 4;       // consistent periods before suppressing
+
+    float getFlickerRemovedFraction() const { return flicker_removed_frac_; }
+    ofxDatGuiTextInput* flickerStatDisplay = nullptr;
+
+    // Event coordinate remap (undistort / rotate / flip / crop via per-pixel LUT).
+    // Calibration is read from data/event_remap.yml if present.
+    dvs::EventRemap event_remap;
+    void reloadEventRemap();
+
+    // Load governor — scales filter aggressiveness to hold update() within budget
+    dvs::LoadGovernor load_governor;
+    ofxDatGuiTextInput* governorCostDisplay = nullptr;
+    ofxDatGuiTextInput* governorSettingsDisplay = nullptr;
+
     // --- Neural network pipelines ---
     bool nnEnabled = false;
     bool tsdtEnabled = false;
     bool tpdvsGestureEnabled = false;
+    bool roiEnabled = false;        // crop inference on the cluster tracker's visible clusters
 
     dvs::YoloPipeline  yolo_pipeline;
     dvs::TsdtPipeline  tsdt_pipeline;
     dvs::TsdtPipeline  tpdvs_gesture_pipeline;
+    dvs::RoiPipeline   roi_pipeline;    // loads data/roi_model.onnx when present
+
+    // ORT thread budget per model: 0 = shared global pool, N = private pool
+    int nnThreadBudgetYolo  = 0;
+    int nnThreadBudgetTsdt  = 0;
+    int nnThreadBudgetTpdvs = 1;    // 32x32 SNN: pool hand-off costs more than it saves
+    int nnThreadBudgetRoi   = 0;
+    void benchmarkInference();      // all loaded models alone vs. concurrently
+
+    // Background model loading / hot swap
+    void pollModelLoads();          // install finished loads (update(), main thread)
+    void reloadModel(const std::string& which, const std::string& path = "");  // "" = same file
+    bool tsdtSelfTested_ = false;
+    float setupStartTime_ = 0.f;    // for the time-to-first-detection log
+    bool  firstYoloLogged_ = false;
+
+    // Detect-then-track: YOLO every yoloDetectEvery image frames (or on
+    // DETECT NOW), boxes carried by the event-driven tracker in between
+    bool yoloTrack = false;
+    int  yoloDetectEvery = 6;
+    bool yoloDetectNow_ = false;
+    int  yoloFramesSinceDetect_ = 0;
+    dvs::BoxTracker box_tracker;
+    ofxDatGuiTextInput* yoloTrackerDisplay = nullptr;
 
     // Async inference workers
     dvs::InferenceWorker<std::vector<dvs::YoloDet>> yolo_worker;
-    dvs::InferenceWorker<std::pair<int,float>>      tsdt_worker;
+    dvs::InferenceWorker<dvs::TsdtResult>           tsdt_worker;
+    dvs::InferenceWorker<dvs::TsdtResult>           tpdvs_worker;
+    dvs::InferenceWorker<dvs::RoiResult>            roi_worker;
+
+    // Event-packet summary for the pipelines' activity gates (built once per update)
+    dvs::ActivitySnapshot activity_;
+    void setActivityGates(const dvs::ActivityGateConfig& c);   // same settings for all pipelines
+    ofxDatGuiTextInput* gateDisplay = nullptr;
+
+    // Model-input dump for INT8 calibration (scripts/quantize_int8.py)
+    dvs::CalibRecorder calib_recorder;
+
+    // Worker latency readouts (NN panel)
+    ofxDatGuiTextInput* yoloWorkerDisplay  = nullptr;
+    ofxDatGuiTextInput* tsdtWorkerDisplay  = nullptr;
+    ofxDatGuiTextInput* tpdvsWorkerDisplay = nullptr;
+    ofxDatGuiTextInput* roiWorkerDisplay   = nullptr;
+    ofxDatGuiTextInput* yoloModelDisplay   = nullptr;
+    ofxDatGuiTextInput* tsdtModelDisplay   = nullptr;
+    ofxDatGuiTextInput* tpdvsModelDisplay  = nullptr;
+    ofxDatGuiTextInput* roiModelDisplay    = nullptr;
 
     // NN / YOLO panel
     std::unique_ptr<ofxDatGui> nn_panel;
@@ -933,6 +1008,8 @@ public:
     int   optFlowRadius   = 3;          // neighborhood half-size (7x7)
     int   optFlowDt_us    = 50000;      // 50 ms temporal window
     float optFlowMaxSpeed = 200.0f;     // display clamp (px/s)
+    bool  optFlowIntegral = false;      // summed-area-table fit (cost independent of radius)
+    void  benchmarkOpticalFlow();
 
     // Event-driven reconstruction — GUI-accessible config
     bool  drawRecon   = false;
@@ -963,6 +1040,25 @@ private:
     void applyHotPixelFilter_();
     void finalizeCalibration_();
 
+    // Flicker suppression — per-pixel periodicity state (internal storage)
+    struct FlickerCell {
+        int64_t onset_ts[2] = {0, 0};   // start of last OFF / ON burst
+        int32_t period_us = 0;          // last burst-to-burst interval
+        uint8_t last_pol = 0;
+        uint8_t lock = 0;               // consecutive in-band, consistent periods
+    };
+    std::vector<FlickerCell> flicker_cells_;
+    float flicker_removed_frac_ = 0.0f;  // smoothed fraction of events removed
+
+    void applyFlickerFilter_();
+    void resetFlickerFilter_();
+
+    // Load governor — spatial decimation (one event per block per frame)
+    std::vector<uint32_t> decim_block_frame_;
+    uint32_t decim_frame_ = 0;
+
+    void applyDecimation_();
+
     // Shutdown guard
     bool exited_ = false;
 
@@ -973,9 +1069,14 @@ private:
     ofShader pointShader;
     float pointSizePx = 8.0f;
 
-    // Event-driven reconstruction (CPU per-pixel decay) — internal storage
-    std::vector<float> reconMap_;   // per-pixel intensity, -1.0 to +1.0
-    ofImage reconImage_;            // color output (OF_IMAGE_COLOR)
+    // Image generator — touched-pixel bookkeeping (single-pass normalization)
+    std::vector<int> spikeTouched_;        // pixels set since the last image
+    std::vector<int> imageGenLit_;         // pixels lit in the current image
+    double spikeSum_ = 0.0, spikeSumSq_ = 0.0;
+    void allocImageGeneratorMaps_();       // (re)size maps to the sensor, settings untouched
+
+    // Event-driven reconstruction (lazy per-pixel decay) — internal storage
+    dvs::EventReconstruction recon_;
 
     // AEDAT4 recording
     std::unique_ptr<dv::io::MonoCameraWriter> aedat4Writer_;
@@ -991,9 +1092,10 @@ private:
     ofxDatGuiTextInput* mySpeedDisplay = nullptr;
 
     // Event-based optical flow (SAE + flow maps, private storage)
-    std::vector<int64_t> saeTimestamp_;
-    std::vector<float>   flowX_, flowY_;
-    ofImage              flowImage_;
+    dvs::OpticalFlow optical_flow_;
+
+    // Worker threads for data-parallel per-event / per-row loops in update()
+    dvs::ThreadPool worker_pool_;
 
     // Packet queue management
     std::deque<caerEventPacketContainer> backlog_;
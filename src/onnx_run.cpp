@@ -4,61 +4,113 @@
 #include <sstream>
 #include <numeric>
 #include <cstdint>
+#include <chrono>
+#include <mutex>
+#include <cstdio>
+#include <iomanip>
+
+#include "dvs_simd.hpp"
+
+// ---- Shared environment / global thread pools ----
+namespace {
+std::mutex g_env_mu;
+OnnxRunner::GlobalThreading g_threading;
+std::unique_ptr<Ort::Env> g_env;
+std::string g_opt_cache_dir;
+}
 
-// ---- float32 <-> float16 helpers (IEEE-754 binary16) ----
-static inline uint16_t f32_to_f16_bits(float f) {
-    uint32_t x; std::memcpy(&x, &f, sizeof(x));
-    uint32_t sign = (x >> 31) & 0x1;
-    int32_t  exp  = int32_t((x >> 23) & 0xFF) - 127 + 15;
-    uint32_t mant = x & 0x7FFFFF;
-
-    if (exp <= 0) {
-        if (exp < -10) return uint16_t(sign << 15);
-        mant = (mant | 0x800000) >> (1 - exp);
-        return uint16_t((sign << 15) | (mant + 0x1000) >> 13);
-    } else if (exp >= 31) {
-        return uint16_t((sign << 15) | (0x1F << 10) | (mant ? 0x200 : 0));
-    } else {
-        return uint16_t((sign << 15) | (exp << 10) | ((mant + 0x1000) >> 13));
+void OnnxRunner::setGlobalThreading(const GlobalThreading& gt) {
+    std::lock_guard<std::mutex> lk(g_env_mu);
+    if (g_env) {
+        ofLogWarning() << "[NN] global threading already fixed by the shared Env; ignoring";
+        return;
     }
+    g_threading = gt;
 }
 
-static inline float f16_bits_to_f32(uint16_t h) {
-    uint32_t sign = (h >> 15) & 0x1;
-    uint32_t exp  = (h >> 10) & 0x1F;
-    uint32_t mant = h & 0x3FF;
-    uint32_t x;
+void OnnxRunner::setOptimizedModelCache(const std::string& dir) {
+    std::lock_guard<std::mutex> lk(g_env_mu);
+    g_opt_cache_dir = dir;
+}
 
-    if (exp == 0) {
-        if (mant == 0) { x = sign << 31; }
-        else {
-            exp = 127 - 15 + 1;
-            while ((mant & 0x400) == 0) { mant <<= 1; --exp; }
-            mant &= 0x3FF;
-            x = (sign << 31) | (exp << 23) | (mant << 13);
-        }
-    } else if (exp == 31) {
-        x = (sign << 31) | (0xFF << 23) | (mant ? 0x7FFFFF : 0);
-    } else {
-        x = (sign << 31) | ((exp - 15 + 127) << 23) | (mant << 13);
+Ort::Env& OnnxRunner::sharedEnv_() {
+    std::lock_guard<std::mutex> lk(g_env_mu);
+    if (!g_env) {
+        int intra = g_threading.intra_op_threads > 0
+                  ? g_threading.intra_op_threads
+                  : (int)std::max(1u, std::thread::hardware_concurrency() / 2);
+        int inter = std::max(1, g_threading.inter_op_threads);
+
+        Ort::ThreadingOptions tp;
+        tp.SetGlobalIntraOpNumThreads(intra);
+        tp.SetGlobalInterOpNumThreads(inter);
+        tp.SetGlobalSpinControl(g_threading.allow_spinning ? 1 : 0);
+        g_env = std::make_unique<Ort::Env>(tp, ORT_LOGGING_LEVEL_WARNING, "ofxDVS_onnx");
+
+        ofLogNotice() << "[NN] shared ORT env: global intra=" << intra
+                      << " inter=" << inter
+                      << " spin=" << (g_threading.allow_spinning ? "on" : "off");
+    }
+    return *g_env;
+}
+
+// ---- Optimized-model cache ----
+static GraphOptimizationLevel graphOptLevel(int level) {
+    switch (level) {
+        case 0:  return GraphOptimizationLevel::ORT_DISABLE_ALL;
+        case 1:  return GraphOptimizationLevel::ORT_ENABLE_BASIC;
+        case 2:  return GraphOptimizationLevel::ORT_ENABLE_EXTENDED;
+        default: return GraphOptimizationLevel::ORT_ENABLE_ALL;
     }
-    float f; std::memcpy(&f, &x, sizeof(f)); return f;
+}
+
+static constexpr uint64_t kFnvOffset = 1469598103934665603ull;
+static constexpr uint64_t kFnvPrime  = 1099511628211ull;
+
+static uint64_t fnv1a(uint64_t h, const void* data, size_t n) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= kFnvPrime; }
+    return h;
+}
+
+/// FNV-1a over the file in 64-bit words (tail bytewise): a content key
+/// that costs ~10 ms per 100 MB.  0 if the file cannot be read.
+static uint64_t hashFile(const std::string& path) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return 0;
+    uint64_t h = kFnvOffset;
+    std::vector<uint64_t> buf(1 << 17);
+    size_t got;
+    while ((got = std::fread(buf.data(), 1, buf.size() * sizeof(uint64_t), f)) > 0) {
+        const size_t words = got / sizeof(uint64_t);
+        for (size_t i = 0; i < words; ++i) { h ^= buf[i]; h *= kFnvPrime; }
+        h = fnv1a(h, reinterpret_cast<const uint8_t*>(buf.data()) + words * sizeof(uint64_t),
+                  got - words * sizeof(uint64_t));
+    }
+    std::fclose(f);
+    return h;
 }
 
 // ---- Constructor ----
 OnnxRunner::OnnxRunner(const Config& cfg)
     : cfg_(cfg),
-      env_(ORT_LOGGING_LEVEL_WARNING, "ofxDVS_onnx"),
       session_options_(),
       mem_info_(Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault))
 {
-    session_options_.SetIntraOpNumThreads(cfg_.intra_op_num_threads);
+    if (cfg_.thread_budget > 0) {
+        // Private pool: this model does not compete on the shared one
+        session_options_.SetIntraOpNumThreads(cfg_.thread_budget);
+        session_options_.SetInterOpNumThreads(1);
+        session_options_.AddConfigEntry("session.intra_op.allow_spinning", "0");
+    } else {
+        session_options_.DisablePerSessionThreads();
+    }
     if (cfg_.verbose) {
         session_options_.SetLogSeverityLevel(0);
     }
 
 #if defined(ORT_API_VERSION) && ORT_API_VERSION >= 8
-    session_options_.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
+    session_options_.SetGraphOptimizationLevel(graphOptLevel(cfg_.graph_opt_level));
 #endif
 }
 
@@ -71,16 +123,134 @@ OnnxRunner::~OnnxRunner() {
 void OnnxRunner::load() {
     if (cfg_.model_path.empty())
         throw std::runtime_error("OnnxRunner: model_path is empty.");
+    using clock = std::chrono::steady_clock;
+    auto ms = [](clock::time_point a, clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+    const auto t0 = clock::now();
+    load_stats_ = LoadStats{};
+
+    loaded_path_ = cfg_.model_path;
+    if (cfg_.prefer_int8) {
+        const std::string q = int8PathFor(cfg_.model_path);
+        if (q != cfg_.model_path && ofFile::doesFileExist(q, false)) loaded_path_ = q;
+    }
 
-    session_ = std::make_unique<Ort::Session>(env_, cfg_.model_path.c_str(), session_options_);
+    session_ = createSession_();
     loaded_ = true;
 
+    // Quantization tag written by scripts/quantize_int8.py
+    quantization_.clear();
+    try {
+        auto md = session_->GetModelMetadata();
+        auto v = md.LookupCustomMetadataMapAllocated("dvs.quantization", allocator_);
+        if (v) quantization_ = v.get();
+    } catch (const Ort::Exception&) {}
+    if (quantization_.empty() && ofIsStringInString(loaded_path_, ".int8.onnx"))
+        quantization_ = "int8";
+
     queryModelIO_();
     buildNameCaches_();
     dumpModelIO_();
 
     if (inputs_.empty())  throw std::runtime_error("OnnxRunner: model has no inputs.");
     if (outputs_.empty()) throw std::runtime_error("OnnxRunner: model has no outputs.");
+
+    if (cfg_.warmup) {
+        try {
+            load_stats_.warmup_ms = runDummy();
+        } catch (const Ort::Exception& e) {
+            ofLogWarning() << "[NN] warm-up run failed: " << e.what();
+        }
+    }
+    load_stats_.total_ms = ms(t0, clock::now());
+
+    ofLogNotice() << "[NN] loaded " << ofFilePath::getFileName(loaded_path_)
+                  << (quantization_.empty() ? "" : " (quantized: " + quantization_ + ")")
+                  << " in " << load_stats_.total_ms << " ms (hash " << load_stats_.hash_ms
+                  << ", session " << load_stats_.session_ms
+                  << (load_stats_.cache_hit ? " from opt cache" : "")
+                  << ", warm-up " << load_stats_.warmup_ms << ")";
+}
+
+std::unique_ptr<Ort::Session> OnnxRunner::createSession_() {
+    using clock = std::chrono::steady_clock;
+    auto ms = [](clock::time_point a, clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(b - a).count();
+    };
+
+    std::string cache_dir;
+    {
+        std::lock_guard<std::mutex> lk(g_env_mu);
+        cache_dir = g_opt_cache_dir;
+    }
+
+    // Cache key: model content, optimization level, ORT version.  Level 3
+    // adds NCHWc layout transforms tied to this CPU's ISA, so that graph is
+    // not cached: a cache directory copied to another box would load it.
+    std::string cached;
+    if (cfg_.use_opt_cache && !cache_dir.empty()
+        && cfg_.graph_opt_level > 0 && cfg_.graph_opt_level < 3) {
+        const auto th = clock::now();
+        uint64_t h = hashFile(loaded_path_);
+        if (h != 0) {
+            const std::string ver = Ort::GetVersionString();
+            h = fnv1a(h, ver.data(), ver.size());
+            h = fnv1a(h, &cfg_.graph_opt_level, sizeof(cfg_.graph_opt_level));
+            std::ostringstream name;
+            name << cache_dir << "/" << ofFilePath::getBaseName(loaded_path_) << "."
+                 << std::hex << std::setw(16) << std::setfill('0') << h
+                 << ".o" << std::dec << cfg_.graph_opt_level << ".onnx";
+            cached = name.str();
+        }
+        load_stats_.hash_ms = ms(th, clock::now());
+    }
+
+    const auto ts = clock::now();
+    std::unique_ptr<Ort::Session> session;
+
+    // Cache hit: the graph is already optimized, skip the optimizer
+    if (!cached.empty() && ofFile::doesFileExist(cached, false)) {
+        Ort::SessionOptions so = session_options_.Clone();
+        so.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+        try {
+            session = std::make_unique<Ort::Session>(sharedEnv_(), cached.c_str(), so);
+            load_stats_.cache_hit = true;
+        } catch (const Ort::Exception& e) {
+            ofLogWarning() << "[NN] unusable optimized model " << cached << " (" << e.what() << "), rebuilding";
+            std::remove(cached.c_str());
+        }
+    }
+
+    // Miss: optimize and let ORT write the result (renamed once complete,
+    // so an interrupted write is never picked up)
+    if (!session) {
+        Ort::SessionOptions so = session_options_.Clone();
+        std::string tmp;
+        if (!cached.empty() && !ofDirectory::doesDirectoryExist(cache_dir, false))
+            ofDirectory::createDirectory(cache_dir, false, true);
+        if (!cached.empty() && ofDirectory::doesDirectoryExist(cache_dir, false)) {
+            tmp = cached + ".tmp";
+            so.SetOptimizedModelFilePath(tmp.c_str());
+        }
+        session = std::make_unique<Ort::Session>(sharedEnv_(), loaded_path_.c_str(), so);
+        if (!tmp.empty() && std::rename(tmp.c_str(), cached.c_str()) != 0) {
+            ofLogWarning() << "[NN] could not store optimized model " << cached;
+            std::remove(tmp.c_str());
+        }
+    }
+
+    load_stats_.session_ms = ms(ts, clock::now());
+    return session;
+}
+
+std::string OnnxRunner::int8PathFor(const std::string& model_path) {
+    const std::string ext = ".onnx";
+    if (model_path.size() < ext.size() ||
+        model_path.compare(model_path.size() - ext.size(), ext.size(), ext) != 0)
+        return model_path;
+    if (ofIsStringInString(model_path, ".int8.onnx")) return model_path;
+    return model_path.substr(0, model_path.size() - ext.size()) + ".int8.onnx";
 }
 
 void OnnxRunner::buildNameCaches_() {
@@ -260,6 +430,324 @@ OnnxRunner::runRawMulti(const std::vector<std::pair<const float*, std::vector<in
     return outmap;
 }
 
+// ---- bindIO ----
+void OnnxRunner::bindIO(const std::vector<std::vector<int64_t>>& input_shapes) {
+    if (!loaded_) throw std::runtime_error("OnnxRunner::bindIO before load().");
+    if (input_shapes.size() != inputs_.size()) {
+        std::ostringstream oss;
+        oss << "OnnxRunner::bindIO: " << input_shapes.size()
+            << " shapes for " << inputs_.size() << " inputs";
+        throw std::runtime_error(oss.str());
+    }
+
+    binding_ = std::make_unique<Ort::IoBinding>(*session_);
+    bound_in_.assign(inputs_.size(), BoundInput{});
+    bound_out_.assign(outputs_.size(), BoundOutput{});
+
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+        auto& b = bound_in_[i];
+        b.shape = input_shapes[i];
+        b.numel = std::accumulate(b.shape.begin(), b.shape.end(), (size_t)1, std::multiplies<size_t>());
+        b.type  = inputs_[i].type;
+        if (b.type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+            b.f16.assign(b.numel, 0);
+            bindInput_(i, b.f16.data());
+        } else if (b.type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+            throw std::runtime_error("OnnxRunner::bindIO: unsupported input type "
+                                     + dataTypeName_(b.type));
+        }
+        // Caller buffers are bound in runBound() / runBoundRaw()
+    }
+
+    for (size_t i = 0; i < outputs_.size(); ++i) {
+        auto& o = bound_out_[i];
+        o.type  = outputs_[i].type;
+        o.shape = outputs_[i].dims;
+        o.allocated = std::all_of(o.shape.begin(), o.shape.end(), [](int64_t d) { return d > 0; });
+        bindOutput_(i);
+    }
+}
+
+// ---- bindOutput_ ----
+void OnnxRunner::bindOutput_(size_t i) {
+    auto& o = bound_out_[i];
+    const char* name = output_names_[i].c_str();
+    if (!o.allocated) {
+        // Dynamic shape: let ORT allocate once, sized on the first run
+        binding_->BindOutput(name, mem_info_);
+        return;
+    }
+    const size_t n = std::accumulate(o.shape.begin(), o.shape.end(), (size_t)1, std::multiplies<size_t>());
+    o.f32.assign(n, 0.f);
+    if (o.type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+        o.f16.assign(n, 0);
+        binding_->BindOutput(name, Ort::Value::CreateTensor<Ort::Float16_t>(
+            mem_info_, reinterpret_cast<Ort::Float16_t*>(o.f16.data()), n,
+            o.shape.data(), o.shape.size()));
+    } else if (o.type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+        binding_->BindOutput(name, Ort::Value::CreateTensor<float>(
+            mem_info_, o.f32.data(), n, o.shape.data(), o.shape.size()));
+    } else {
+        throw std::runtime_error("OnnxRunner::bindIO: unsupported output type "
+                                 + dataTypeName_(o.type));
+    }
+}
+
+// ---- bindOutputTo ----
+void OnnxRunner::bindOutputTo(size_t i, float* data, const std::vector<int64_t>& shape) {
+    if (!binding_) throw std::runtime_error("OnnxRunner::bindOutputTo before bindIO().");
+    auto& o = bound_out_.at(i);
+    if (o.type != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT)
+        throw std::runtime_error("OnnxRunner::bindOutputTo: output is not float32.");
+
+    if (!o.external) {
+        // Own buffer no longer needed
+        std::vector<float>().swap(o.f32);
+        o.external  = true;
+        o.allocated = true;
+        o.shape     = shape;
+    }
+    const size_t n = std::accumulate(shape.begin(), shape.end(), (size_t)1, std::multiplies<size_t>());
+    binding_->BindOutput(output_names_[i].c_str(), Ort::Value::CreateTensor<float>(
+        mem_info_, data, n, o.shape.data(), o.shape.size()));
+}
+
+int OnnxRunner::outputIndex(const std::string& name) const {
+    for (size_t i = 0; i < output_names_.size(); ++i)
+        if (output_names_[i] == name) return (int)i;
+    return -1;
+}
+
+// ---- bindInput_ ----
+void OnnxRunner::bindInput_(size_t i, const void* data) {
+    auto& b = bound_in_[i];
+    if (data == b.bound_ptr) return;
+    if (b.type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+        binding_->BindInput(input_names_[i].c_str(), Ort::Value::CreateTensor<Ort::Float16_t>(
+            mem_info_, reinterpret_cast<Ort::Float16_t*>(const_cast<void*>(data)), b.numel,
+            b.shape.data(), b.shape.size()));
+    } else {
+        binding_->BindInput(input_names_[i].c_str(), Ort::Value::CreateTensor<float>(
+            mem_info_, static_cast<float*>(const_cast<void*>(data)), b.numel,
+            b.shape.data(), b.shape.size()));
+    }
+    b.bound_ptr = data;
+}
+
+// ---- runBound ----
+void OnnxRunner::runBound(const std::vector<const float*>& inputs) {
+    if (!binding_) throw std::runtime_error("OnnxRunner::runBound before bindIO().");
+    if (inputs.size() != bound_in_.size())
+        throw std::runtime_error("OnnxRunner::runBound: input count mismatch.");
+
+    for (size_t i = 0; i < bound_in_.size(); ++i) {
+        auto& b = bound_in_[i];
+        if (b.type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+            dvs::simd::f32ToF16(inputs[i], b.f16.data(), b.numel);
+            bindInput_(i, b.f16.data());
+        } else {
+            bindInput_(i, inputs[i]);
+        }
+    }
+    runBound_();
+}
+
+void OnnxRunner::runBoundRaw(const std::vector<const void*>& inputs) {
+    if (!binding_) throw std::runtime_error("OnnxRunner::runBoundRaw before bindIO().");
+    if (inputs.size() != bound_in_.size())
+        throw std::runtime_error("OnnxRunner::runBoundRaw: input count mismatch.");
+
+    for (size_t i = 0; i < bound_in_.size(); ++i) bindInput_(i, inputs[i]);
+    runBound_();
+}
+
+void OnnxRunner::runBound_() {
+    session_->Run(Ort::RunOptions{nullptr}, *binding_);
+
+    bool rebind = false;
+    for (size_t i = 0; i < bound_out_.size(); ++i) {
+        auto& o = bound_out_[i];
+        if (!o.allocated) {
+            // First run of a dynamic-shape output: adopt its shape, then bind
+            // a persistent buffer for the following runs
+            auto values = binding_->GetOutputValues();
+            auto tinf = values[i].GetTensorTypeAndShapeInfo();
+            o.shape = tinf.GetShape();
+            o.allocated = true;
+            bindOutput_(i);
+            const size_t n = tinf.GetElementCount();
+            if (o.type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+                const uint16_t* q = reinterpret_cast<const uint16_t*>(values[i].GetTensorData<Ort::Float16_t>());
+                dvs::simd::f16ToF32(q, o.f32.data(), n);
+            } else {
+                const float* p = values[i].GetTensorData<float>();
+                std::copy(p, p + n, o.f32.begin());
+            }
+            rebind = true;
+        } else if (o.type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+            dvs::simd::f16ToF32(o.f16.data(), o.f32.data(), o.f32.size());
+        }
+    }
+    if (rebind)
+        ofLogNotice() << "[NN] bound dynamic-shape outputs after first run";
+}
+
+// ---- runBatch ----
+bool OnnxRunner::supportsBatch() const {
+    return !inputs_.empty() && !inputs_[0].dims.empty() && inputs_[0].dims[0] <= 0;
+}
+
+std::map<std::string, std::vector<float>>
+OnnxRunner::runBatch(const std::vector<const void*>& items, const std::vector<int64_t>& item_shape)
+{
+    if (!loaded_) throw std::runtime_error("OnnxRunner::runBatch before load().");
+    if (inputs_.size() != 1)
+        throw std::runtime_error("OnnxRunner::runBatch: single-input models only.");
+    if (items.empty() || item_shape.empty() || item_shape[0] != 1)
+        throw std::runtime_error("OnnxRunner::runBatch: need items and a [1, ...] item shape.");
+
+    const size_t N = items.size();
+    const size_t per = std::accumulate(item_shape.begin(), item_shape.end(), (size_t)1,
+                                       std::multiplies<size_t>());
+    std::vector<int64_t> shape = item_shape;
+    shape[0] = (int64_t)N;
+
+    Ort::Value input{nullptr};
+    if (inputs_[0].type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+        batch_f16_.resize(N * per);
+        for (size_t k = 0; k < N; ++k)
+            std::memcpy(batch_f16_.data() + k * per, items[k], per * sizeof(uint16_t));
+        input = Ort::Value::CreateTensor<Ort::Float16_t>(
+            mem_info_, reinterpret_cast<Ort::Float16_t*>(batch_f16_.data()), N * per,
+            shape.data(), shape.size());
+    } else if (inputs_[0].type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+        batch_f32_.resize(N * per);
+        for (size_t k = 0; k < N; ++k)
+            std::memcpy(batch_f32_.data() + k * per, items[k], per * sizeof(float));
+        input = Ort::Value::CreateTensor<float>(
+            mem_info_, batch_f32_.data(), N * per, shape.data(), shape.size());
+    } else {
+        throw std::runtime_error("OnnxRunner::runBatch: unsupported input type "
+                                 + dataTypeName_(inputs_[0].type));
+    }
+
+    auto outs = session_->Run(Ort::RunOptions{nullptr},
+                              in_names_c_.data(), &input, 1,
+                              out_names_c_.data(), out_names_c_.size());
+
+    std::map<std::string, std::vector<float>> outmap;
+    for (size_t i = 0; i < outs.size(); ++i) {
+        auto tinf = outs[i].GetTensorTypeAndShapeInfo();
+        const size_t count = tinf.GetElementCount();
+        auto& dst = outmap[output_names_[i]];
+        dst.resize(count);
+        if (tinf.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+            dvs::simd::f16ToF32(reinterpret_cast<const uint16_t*>(outs[i].GetTensorData<Ort::Float16_t>()),
+                                dst.data(), count);
+        } else {
+            const float* p = outs[i].GetTensorData<float>();
+            std::copy(p, p + count, dst.begin());
+        }
+    }
+    return outmap;
+}
+
+// ---- runDummy ----
+double OnnxRunner::runDummy() {
+    if (!loaded_) throw std::runtime_error("OnnxRunner::runDummy before load().");
+
+    std::vector<std::vector<float>>    f32(inputs_.size());
+    std::vector<std::vector<uint16_t>> f16(inputs_.size());
+    std::vector<std::vector<int64_t>>  shapes(inputs_.size());
+    std::vector<Ort::Value> values;
+    values.reserve(inputs_.size());
+
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+        auto& shape = shapes[i];
+        shape = inputs_[i].dims;
+        for (auto& d : shape) if (d <= 0) d = 1;
+        const size_t n = std::accumulate(shape.begin(), shape.end(), (size_t)1, std::multiplies<size_t>());
+
+        if (inputs_[i].type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+            f32[i].assign(n, 0.f);
+            values.push_back(Ort::Value::CreateTensor<float>(
+                mem_info_, f32[i].data(), n, shape.data(), shape.size()));
+        } else if (inputs_[i].type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+            f16[i].assign(n, 0);
+            values.push_back(Ort::Value::CreateTensor<Ort::Float16_t>(
+                mem_info_, reinterpret_cast<Ort::Float16_t*>(f16[i].data()), n,
+                shape.data(), shape.size()));
+        } else {
+            throw std::runtime_error("OnnxRunner::runDummy: unsupported input type "
+                                     + dataTypeName_(inputs_[i].type));
+        }
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    session_->Run(Ort::RunOptions{nullptr},
+                  in_names_c_.data(), values.data(), values.size(),
+                  out_names_c_.data(), out_names_c_.size());
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// ---- benchmarkConcurrent ----
+void OnnxRunner::benchmarkConcurrent(const std::vector<std::pair<std::string, OnnxRunner*>>& models,
+                                     int iters)
+{
+    std::vector<std::pair<std::string, OnnxRunner*>> live;
+    for (const auto& m : models)
+        if (m.second && m.second->isLoaded()) live.push_back(m);
+    if (live.empty()) {
+        ofLogWarning() << "[NN bench] no models loaded";
+        return;
+    }
+    iters = std::max(1, iters);
+
+    auto meanMs = [iters](OnnxRunner* r) {
+        r->runDummy();  // warm-up
+        double sum = 0.0;
+        for (int i = 0; i < iters; ++i) sum += r->runDummy();
+        return sum / iters;
+    };
+
+    std::vector<double> alone(live.size()), together(live.size());
+    for (size_t i = 0; i < live.size(); ++i) alone[i] = meanMs(live[i].second);
+
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < live.size(); ++i)
+            threads.emplace_back([&, i] {
+                try { together[i] = meanMs(live[i].second); }
+                catch (const std::exception& e) {
+                    ofLogError() << "[NN bench] " << live[i].first << ": " << e.what();
+                }
+            });
+        for (auto& t : threads) t.join();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    int global_intra;
+    {
+        std::lock_guard<std::mutex> lk(g_env_mu);
+        global_intra = g_threading.intra_op_threads > 0
+                     ? g_threading.intra_op_threads
+                     : (int)std::max(1u, std::thread::hardware_concurrency() / 2);
+    }
+    ofLogNotice() << "[NN bench] " << live.size() << " models, " << iters << " runs each"
+                  << " (global intra=" << global_intra << ")";
+    for (size_t i = 0; i < live.size(); ++i) {
+        ofLogNotice() << "[NN bench]   " << live[i].first
+                      << " budget=" << (live[i].second->cfg_.thread_budget > 0
+                                        ? std::to_string(live[i].second->cfg_.thread_budget) : "shared")
+                      << "  alone " << alone[i] << " ms"
+                      << "  concurrent " << together[i] << " ms";
+    }
+    ofLogNotice() << "[NN bench]   concurrent wall "
+                  << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms";
+}
+
 // ---- runCHW (allocating) ----
 std::unordered_map<std::string, std::vector<float>>
 OnnxRunner::runCHW(const std::vector<float>& chw, int C, int H, int W)
@@ -308,8 +796,7 @@ void OnnxRunner::runCHW_impl_(const std::vector<float>& chw, int C, int H, int W
     } else if (in0.type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
         // Reuse pre-allocated FP16 buffer
         chw_f16_buf_.resize(need);
-        for (size_t i = 0; i < need; ++i)
-            chw_f16_buf_[i] = f32_to_f16_bits(chw[i]);
+        dvs::simd::f32ToF16(chw.data(), chw_f16_buf_.data(), need);
         input_tensor = Ort::Value::CreateTensor<Ort::Float16_t>(
             mem_info_,
             reinterpret_cast<Ort::Float16_t*>(chw_f16_buf_.data()),
@@ -345,7 +832,7 @@ void OnnxRunner::runCHW_impl_(const std::vector<float>& chw, int C, int H, int W
         } else if (et == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
             const uint16_t* q = reinterpret_cast<const uint16_t*>(v.GetTensorData<Ort::Float16_t>());
             dst.resize(count);
-            for (size_t k = 0; k < count; ++k) dst[k] = f16_bits_to_f32(q[k]);
+            dvs::simd::f16ToF32(q, dst.data(), count);
         } else {
             std::ostringstream oss;
             oss << "OnnxRunner: unsupported output type " << dataTypeName_(et);
@@ -399,7 +886,7 @@ OnnxRunner::run(const ofImage& img)
             mem_info_, chw.data(), chw.size(), input_shape.data(), input_shape.size());
     } else { // FLOAT16
         chw_f16_buf_.resize(chw.size());
-        for (size_t i = 0; i < chw.size(); ++i) chw_f16_buf_[i] = f32_to_f16_bits(chw[i]);
+        dvs::simd::f32ToF16(chw.data(), chw_f16_buf_.data(), chw.size());
         input_tensor = Ort::Value::CreateTensor<Ort::Float16_t>(
             mem_info_,
             reinterpret_cast<Ort::Float16_t*>(chw_f16_buf_.data()),
@@ -431,7 +918,7 @@ OnnxRunner::run(const ofImage& img)
         } else if (elem_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
             const uint16_t* d16 = reinterpret_cast<const uint16_t*>(val.GetTensorData<Ort::Float16_t>());
             std::vector<float> out(count);
-            for (size_t k = 0; k < count; ++k) out[k] = f16_bits_to_f32(d16[k]);
+            dvs::simd::f16ToF32(d16, out.data(), count);
             results[output_names_[i]] = std::move(out);
         } else {
             std::ostringstream oss;
@@ -6,6 +6,7 @@
 #include <stdexcept>
 #include <sstream>
 #include <thread>
+#include <map>
 
 #include "ofMain.h"
 
@@ -38,13 +39,53 @@ public:
 
     struct Config {
         std::string model_path;
-        int intra_op_num_threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+        /// Threads for this model.  0 = run on the process-wide ORT pool shared
+        /// by all runners (see GlobalThreading); N > 0 = private intra-op pool
+        /// of N threads (1 = run on the calling thread only).
+        int thread_budget = 0;
         bool use_cuda = false;        // requires CUDA build of onnxruntime
+        /// Load "<stem>.int8.onnx" next to model_path instead when it exists
+        /// (QDQ model from scripts/quantize_int8.py).
+        bool prefer_int8 = true;
+        /// ORT graph optimization: 0 = off, 1 = basic, 2 = extended,
+        /// 3 = all (adds hardware-specific layout transforms).
+        int  graph_opt_level = 2;
+        /// Reuse the optimized graph from the on-disk cache
+        /// (see setOptimizedModelCache) instead of re-optimizing at load.
+        /// Levels 1-2 only; level 3 graphs are hardware-specific.
+        bool use_opt_cache = true;
+        /// Run once on zero inputs at load so the first real run is not the
+        /// slow one (allocator arenas, kernel selection).
+        bool warmup = true;
         bool verbose = false;
         // Preproc
         bool normalize_01 = true;     // scale to [0,1]
     };
 
+    /// Process-wide ORT thread pools, shared by every runner with
+    /// thread_budget == 0.  Applied when the shared Env is created, i.e. by
+    /// the first OnnxRunner; later changes are ignored.
+    struct GlobalThreading {
+        int  intra_op_threads = 0;     ///< 0 = hardware_concurrency / 2
+        int  inter_op_threads = 1;
+        bool allow_spinning   = false; ///< spinning workers burn cores between runs
+    };
+    static void setGlobalThreading(const GlobalThreading& gt);
+
+    /// Directory for optimized models, keyed by a hash of the model file,
+    /// the optimization level and the ORT version.  Empty = no cache.
+    /// Only graph_opt_level 1-2 is cached (portable across machines).
+    static void setOptimizedModelCache(const std::string& dir);
+
+    /// Where load() spent its time.
+    struct LoadStats {
+        double hash_ms    = 0.0;   ///< hashing the model file for the cache key
+        double session_ms = 0.0;   ///< session creation (incl. graph optimization)
+        double warmup_ms  = 0.0;   ///< dummy run
+        double total_ms   = 0.0;
+        bool   cache_hit  = false; ///< session created from the optimized cache
+    };
+
     explicit OnnxRunner(const Config& cfg);
     ~OnnxRunner();
 
@@ -52,6 +93,21 @@ public:
     void load();
     bool isLoaded() const { return loaded_; }
 
+    const Config& config() const { return cfg_; }
+
+    /// Path of the model actually loaded (the INT8 sibling if one was picked).
+    const std::string& loadedPath() const { return loaded_path_; }
+    const LoadStats& loadStats() const { return load_stats_; }
+
+    /// True when the loaded model is quantized, i.e. it carries the
+    /// "dvs.quantization" metadata written by scripts/quantize_int8.py or
+    /// (untagged) its file name ends in .int8.onnx.
+    bool isQuantized() const { return !quantization_.empty(); }
+    const std::string& quantization() const { return quantization_; }
+
+    /// "<stem>.int8.onnx" for "<stem>.onnx".
+    static std::string int8PathFor(const std::string& model_path);
+
     // Introspect model I/O
     const std::vector<IOInfo>& inputs()  const { return inputs_;  }
     const std::vector<IOInfo>& outputs() const { return outputs_; }
@@ -70,6 +126,66 @@ public:
     std::map<std::string, std::vector<float>>
     runRawMulti(const std::vector<std::pair<const float*, std::vector<int64_t>>>& inputs);
 
+    // ---- Bound-session API (Ort::IoBinding) ----
+
+    /// Set up an IoBinding for the given input shapes (one per model input,
+    /// in model order).  Output buffers are allocated once here; outputs with
+    /// dynamic dims are sized by the first runBound().  Call again to rebind
+    /// with new shapes.
+    void bindIO(const std::vector<std::vector<int64_t>>& input_shapes);
+    bool isBound() const { return binding_ != nullptr; }
+
+    /// Run on caller-owned float32 inputs (model order), which must stay
+    /// alive until the call returns.  float32 inputs are bound zero-copy and
+    /// re-bound only when a pointer changes; float16 inputs are converted
+    /// into persistent staging.  Outputs are written in place into the bound
+    /// buffers: no tensor allocation and no output copy per run.
+    void runBound(const std::vector<const float*>& inputs);
+
+    /// Same, but each input is already in the model's element type (float32,
+    /// or IEEE binary16 bits as uint16_t for float16 inputs) and is bound
+    /// zero-copy, so producers can write half precision directly.
+    void runBoundRaw(const std::vector<const void*>& inputs);
+    bool inputIsF16(size_t i) const {
+        return inputs_.at(i).type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16;
+    }
+
+    /// Bind float32 output i to a caller-owned buffer of `shape` instead of
+    /// the runner's own (e.g. ping-pong recurrent state).  The buffer must
+    /// stay alive for every runBound() until rebound; boundOutput(i) is not
+    /// valid for such an output.
+    void bindOutputTo(size_t i, float* data, const std::vector<int64_t>& shape);
+
+    /// Output i of the last runBound() (float16 outputs are converted into a
+    /// persistent float buffer).
+    const std::vector<float>& boundOutput(size_t i) const { return bound_out_.at(i).f32; }
+    const std::vector<int64_t>& boundOutputShape(size_t i) const { return bound_out_.at(i).shape; }
+
+    /// Index of the output called `name`, or -1.
+    int outputIndex(const std::string& name) const;
+
+    // ---- Batched run (offline throughput) ----
+
+    /// True if the first input's leading (batch) dim is dynamic.
+    bool supportsBatch() const;
+
+    /// Run N same-shape samples of a single-input model as one [N, ...]
+    /// call.  Each item is in the model's input element type (float32, or
+    /// binary16 bits for float16 models) and shaped like `item_shape`, whose
+    /// leading dim must be 1.  Items are gathered into a persistent batch
+    /// buffer; outputs are returned as float with leading dim N, so item k's
+    /// slice is [k * size / N, (k + 1) * size / N).
+    std::map<std::string, std::vector<float>>
+    runBatch(const std::vector<const void*>& items, const std::vector<int64_t>& item_shape);
+
+    /// Run once on zero-filled inputs (dynamic dims = 1); returns wall ms.
+    double runDummy();
+
+    /// Time each model alone, then all of them concurrently (one thread per
+    /// model), and log the mean latency per model for both cases.
+    static void benchmarkConcurrent(const std::vector<std::pair<std::string, OnnxRunner*>>& models,
+                                    int iters = 20);
+
 
 private:
     void queryModelIO_();
@@ -85,9 +201,18 @@ private:
 
     Config cfg_;
     bool loaded_ = false;
+    std::string loaded_path_;
+    std::string quantization_;   ///< "" = float model, else e.g. "int8-qdq"
+    LoadStats load_stats_;
+
+    /// Create the session for loaded_path_, through the optimized-model cache
+    /// when enabled.
+    std::unique_ptr<Ort::Session> createSession_();
+
+    /// Env shared by all runners, created on first use with GlobalThreading.
+    static Ort::Env& sharedEnv_();
 
     // ORT objects
-    Ort::Env env_;
     Ort::SessionOptions session_options_;
     std::unique_ptr<Ort::Session> session_;
     Ort::AllocatorWithDefaultOptions allocator_;
@@ -105,4 +230,31 @@ private:
 
     // Pre-allocated FP16 conversion buffer (reused across calls)
     mutable std::vector<uint16_t> chw_f16_buf_;
+
+    // Gathered runBatch() input (one of the two, by input type)
+    std::vector<float>    batch_f32_;
+    std::vector<uint16_t> batch_f16_;
+
+    // IoBinding state (bound-session API)
+    struct BoundInput {
+        std::vector<int64_t> shape;
+        size_t numel = 0;
+        ONNXTensorElementDataType type = ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+        const void* bound_ptr = nullptr;    ///< buffer currently bound (caller's or f16)
+        std::vector<uint16_t> f16;          ///< float16: persistent staging
+    };
+    struct BoundOutput {
+        std::vector<int64_t> shape;
+        ONNXTensorElementDataType type = ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+        std::vector<float> f32;             ///< bound directly for float32 outputs
+        std::vector<uint16_t> f16;          ///< bound for float16 outputs
+        bool allocated = false;             ///< false until the shape is known
+        bool external  = false;             ///< bound to a caller buffer (bindOutputTo)
+    };
+    void bindInput_(size_t i, const void* data);
+    void bindOutput_(size_t i);
+    void runBound_();   ///< Run the binding and refresh the float outputs
+    std::unique_ptr<Ort::IoBinding> binding_;
+    std::vector<BoundInput>  bound_in_;
+    std::vector<BoundOutput> bound_out_;
 };